@@ -1,11 +1,79 @@
 ﻿#include "AIController.h"
+#include "OpeningBook.h"
+#include "Profiler.h"
+#include "ShipPlacements.h"
 #include <algorithm>
 #include <iostream>
+#include <type_traits>
+
+namespace {
+
+    // Клетки с наибольшим значением карты, по которым ещё не стреляли
+    template <class Rules, class Map>
+    typename Rules::Bitboard bestCells(const Map& map, const BasicShotsGrid<Rules::BoardSize>& shots) noexcept
+    {
+        using Bitboard = typename Rules::Bitboard;
+        using Score = std::remove_cvref_t<decltype(map[0][0])>;
+
+        Score bestScore{};
+        Bitboard best;
+
+        for (int y = 0; y < static_cast<int>(Rules::BoardSize); ++y) {
+            for (int x = 0; x < static_cast<int>(Rules::BoardSize); ++x) {
+                if (shots[y][x]) continue;
+
+                const Score score = map[y][x];
+
+                if (best.none() || score > bestScore) {
+                    bestScore = score;
+                    best = Bitboard::cell(x, y);
+                }
+                else if (score == bestScore) {
+                    best.set(Bitboard::indexOf(x, y));
+                }
+            }
+        }
+        return best;
+    }
+
+    // Случайная из лучших клеток (по порядку строк, как они и собирались)
+    template <std::size_t Width, std::size_t Height>
+    Coord pickAmong(const BasicBitboard<Width, Height>& best, std::mt19937& rng) noexcept
+    {
+        std::uniform_int_distribution<size_t> dist(0, static_cast<size_t>(best.count()) - 1);
+        const std::size_t index = best.nth(static_cast<int>(dist(rng)));
+        return Coord(static_cast<int>(index % Width), static_cast<int>(index / Width));
+    }
+
+    // Соли ключей ShotCache: выбор разными способами хранится раздельно
+    constexpr std::uint64_t SearchSalt = 0x5EA4C4ull << 40;
+    constexpr std::uint64_t MonteCarloSalt = 0x3C3A9ull << 44;
+
+    // Длина затопленного корабля — прямая цепочка попаданий через клетку
+    // (корабли не касаются, поэтому чужих попаданий в ней нет)
+    template <std::size_t Width, std::size_t Height>
+    int hitRunLength(const BasicBitboard<Width, Height>& hits, int x, int y) noexcept
+    {
+        using Bitboard = BasicBitboard<Width, Height>;
+        constexpr int n = static_cast<int>(Width);
+        auto run = [&](int dx, int dy) {
+            int len = 0;
+            for (int cx = x + dx, cy = y + dy;
+                cx >= 0 && cx < n && cy >= 0 && cy < n && hits.test(Bitboard::indexOf(cx, cy));
+                cx += dx, cy += dy)
+                ++len;
+            return len;
+        };
+        return 1 + std::max(run(1, 0) + run(-1, 0), run(0, 1) + run(0, -1));
+    }
+
+} // namespace
 
 // ------------------------------------------------------------
 //  Конструктор
 // ------------------------------------------------------------
-AIController::AIController(std::mt19937& rng) noexcept
+template <class Rules>
+BasicAIController<Rules>::BasicAIController(std::mt19937& rng) noexcept
     : rng_(rng)
 {
 }
@@ -13,33 +81,38 @@ AIController::AIController(std::mt19937& rng) noexcept
 // ------------------------------------------------------------
 //  Помечаем все клетки вокруг затопленного корабля как недоступные
 // ------------------------------------------------------------
-void AIController::markForbiddenAroundHit(
-    int x, int y,
-    const Board& board,
+template <class Rules>
+void BasicAIController<Rules>::markForbiddenAroundShip(
+    const Ship& ship,
     ShotsGrid& shots
 ) noexcept
 {
-    for (int dy = -1; dy <= 1; ++dy) {
-        for (int dx = -1; dx <= 1; ++dx) {
-
-            if (dx == 0 && dy == 0)
-                continue;
-
-            int nx = x + dx;
-            int ny = y + dy;
+    shipPlacementAt<Rules>(ship.x, ship.y, ship.length, ship.horizontal)->halo.forEach([&](std::size_t index) {
+        shots[index / Rules::BoardSize][index % Rules::BoardSize] = true;
+        });
+}
 
-            if (!board.isInside(nx, ny))
-                continue;
+// ------------------------------------------------------------
+//  Вывод по полю: вода закрывается так же, как окружение затопленных
+// ------------------------------------------------------------
+template <class Rules>
+void BasicAIController<Rules>::applyDeductions(
+    const Board& board,
+    ShotsGrid& shots
+) noexcept
+{
+    deductions_ = propagateConstraints(board);
 
-            shots[ny][nx] = true;
-        }
-    }
+    deductions_.water.forEach([&](std::size_t index) {
+        shots[index / Rules::BoardSize][index % Rules::BoardSize] = true;
+        });
 }
 
 // ------------------------------------------------------------
 //  Добавление соседних клеток (только 4 направления)
 // ------------------------------------------------------------
-void AIController::addNeighborsSmart(
+template <class Rules>
+void BasicAIController<Rules>::addNeighborsSmart(
     int x, int y,
     const Board& board,
     const ShotsGrid& shots
@@ -48,11 +121,11 @@ void AIController::addNeighborsSmart(
     if (state_.hasDirection)
         return;
 
-    static const std::array<sf::Vector2i, 4> dirs{
-        sf::Vector2i{ 1, 0 },
-        sf::Vector2i{-1, 0 },
-        sf::Vector2i{ 0, 1 },
-        sf::Vector2i{ 0,-1 }
+    static const std::array<Coord, 4> dirs{
+        Coord{ 1, 0 },
+        Coord{-1, 0 },
+        Coord{ 0, 1 },
+        Coord{ 0,-1 }
     };
 
     for (auto d : dirs) {
@@ -65,7 +138,7 @@ void AIController::addNeighborsSmart(
         if (shots[ny][nx])
             continue;
 
-        auto st = board.cells()[ny][nx];
+        auto st = board.cellAt(nx, ny);
         if (st == CellState::Miss || st == CellState::Sunk)
             continue;
 
@@ -76,23 +149,25 @@ void AIController::addNeighborsSmart(
 // ------------------------------------------------------------
 //  Сортировка попаданий вдоль направления
 // ------------------------------------------------------------
-void AIController::sortHits() noexcept
+template <class Rules>
+void BasicAIController<Rules>::sortHits() noexcept
 {
     if (!state_.hasDirection || state_.hitCells.size() < 2)
         return;
 
     if (state_.dx != 0) {
-        std::ranges::sort(state_.hitCells, {}, &sf::Vector2i::x);
+        std::ranges::sort(state_.hitCells, {}, &Coord::x);
     }
     else {
-        std::ranges::sort(state_.hitCells, {}, &sf::Vector2i::y);
+        std::ranges::sort(state_.hitCells, {}, &Coord::y);
     }
 }
 
 // ------------------------------------------------------------
 //  Сброс направления и пересборка целей
 // ------------------------------------------------------------
-void AIController::resetDirectionAndRebuildTargets(
+template <class Rules>
+void BasicAIController<Rules>::resetDirectionAndRebuildTargets(
     const Board& board,
     const ShotsGrid& shots
 ) noexcept
@@ -108,7 +183,8 @@ void AIController::resetDirectionAndRebuildTargets(
 // ------------------------------------------------------------
 //  Обработка попадания
 // ------------------------------------------------------------
-void AIController::handleHit(
+template <class Rules>
+void BasicAIController<Rules>::handleHit(
     int x, int y,
     Board& board,
     ShotsGrid& shots
@@ -116,13 +192,13 @@ void AIController::handleHit(
 {
     state_.addHit({ x, y });
 
-    // Если корабль затоплен — закрываем диагонали вокруг всех палуб
-    if (board.cells()[y][x] == CellState::Sunk) {
+    // Если корабль затоплен — закрываем клетки вокруг всех его палуб
+    // и вычёркиваем его длину из оставшегося флота
+    if (board.cellAt(x, y) == CellState::Sunk) {
 
-        for (const auto& h : state_.hitCells)
-            markForbiddenAroundHit(h.x, h.y, board, shots);
+        state_.markSunk(hitRunLength(board.hits(), x, y));
 
-        markForbiddenAroundHit(x, y, board, shots);
+        markForbiddenAroundShip(*board.lastSunk(), shots);
 
         state_.resetShipTracking();
         return;
@@ -174,7 +250,7 @@ void AIController::handleHit(
             if (!board.isInside(cx, cy)) return false;
             if (shots[cy][cx]) return false;
 
-            auto st = board.cells()[cy][cx];
+            auto st = board.cellAt(cx, cy);
             return st != CellState::Miss && st != CellState::Sunk;
             };
 
@@ -204,55 +280,199 @@ void AIController::handleHit(
 // ------------------------------------------------------------
 //  Основной ход ИИ
 // ------------------------------------------------------------
-bool AIController::takeTurn(
+template <class Rules>
+bool BasicAIController<Rules>::takeTurn(
     Board& playerBoard,
     ShotsGrid& shots,
     bool& playerTurn,
     bool& playerWon
 ) noexcept
 {
-    std::optional<sf::Vector2i> chosen;
+    const Coord target = chooseShot(playerBoard, shots);
+    return applyShot(target, playerBoard, shots, playerTurn, playerWon);
+}
 
-    // Удаляем недействительные цели
-    std::erase_if(state_.targets, [&](const sf::Vector2i& t) {
-        return !playerBoard.isInside(t.x, t.y) || shots[t.y][t.x];
-        });
+// ------------------------------------------------------------
+//  Упреждающий поиск
+// ------------------------------------------------------------
+template <class Rules>
+void BasicAIController<Rules>::enableSearch(const SearchConfig& config)
+    requires IsClassicRules<Rules>
+{
+    search_ = std::make_unique<LookaheadSearch>(config);
+}
 
-    // Если есть цели — берём последнюю
-    if (!state_.targets.empty()) {
-        chosen = state_.targets.back();
-        state_.targets.pop_back();
-    }
+template <class Rules>
+void BasicAIController<Rules>::disableSearch() noexcept
+{
+    search_.reset();
+}
 
-    // Иначе — вероятностная карта
-    if (!chosen) {
-        prob_.compute(playerBoard, shots);
+// ------------------------------------------------------------
+//  Карта Монте-Карло
+// ------------------------------------------------------------
+template <class Rules>
+void BasicAIController<Rules>::enableMonteCarloMap(const MonteCarloConfig& config)
+    requires IsClassicRules<Rules>
+{
+    monteCarlo_ = std::make_unique<MonteCarloMap>(config);
+}
 
-        int bestScore = -1;
-        std::vector<sf::Vector2i> best;
+template <class Rules>
+void BasicAIController<Rules>::disableMonteCarloMap() noexcept
+{
+    monteCarlo_.reset();
+}
 
-        for (int y = 0; y < BOARD_SIZE; ++y) {
-            for (int x = 0; x < BOARD_SIZE; ++x) {
-                if (shots[y][x]) continue;
+// ------------------------------------------------------------
+//  Точный решатель эндшпиля
+// ------------------------------------------------------------
+template <class Rules>
+void BasicAIController<Rules>::enableEndgameSolver(const EndgameConfig& config)
+    requires IsClassicRules<Rules>
+{
+    endgame_ = std::make_unique<EndgameSolver>(config);
+}
 
-                int score = prob_.map[y][x];
+template <class Rules>
+void BasicAIController<Rules>::disableEndgameSolver() noexcept
+{
+    endgame_.reset();
+}
 
-                if (score > bestScore) {
-                    bestScore = score;
-                    best.clear();
-                    best.emplace_back(x, y);
-                }
-                else if (score == bestScore) {
-                    best.emplace_back(x, y);
+// ------------------------------------------------------------
+//  Кэш выбора
+// ------------------------------------------------------------
+template <class Rules>
+void BasicAIController<Rules>::setShotCache(ShotCache* cache) noexcept
+    requires IsClassicRules<Rules>
+{
+    cache_ = cache;
+}
+
+template <class Rules>
+void BasicAIController<Rules>::setOpeningBook(const OpeningBook* book) noexcept
+    requires IsClassicRules<Rules>
+{
+    book_ = book;
+}
+
+// ------------------------------------------------------------
+//  Выбор клетки
+// ------------------------------------------------------------
+template <class Rules>
+Coord BasicAIController<Rules>::chooseShot(
+    const Board& playerBoard,
+    const ShotsGrid& shots,
+    const std::atomic<bool>* cancel
+) noexcept
+{
+    ProfileScope profile(ProfileZone::AiThink);
+
+    // Мало согласованных расстановок — оптимальный выстрел
+    if constexpr (IsClassicRules<Rules>) {
+        if (endgame_) {
+            lastEndgame_ = endgame_->solve(playerBoard);
+            if (lastEndgame_.solved)
+                return lastEndgame_.best;
+        }
+    }
+
+    // Видимое состояние есть в книге или уже встречалось — выбор оттуда
+    const std::uint64_t observed = playerBoard.observedHash();
+    auto cached = [&](std::uint64_t key) -> std::optional<Bitboard> {
+        if constexpr (IsClassicRules<Rules>) {
+            if (book_) {
+                if (auto best = book_->find(key)) {
+                    ++bookMoves_;
+                    return best;
                 }
             }
+            if (cache_)
+                return cache_->find(key);
         }
+        return std::nullopt;
+    };
+    auto remember = [&](std::uint64_t key, const Bitboard& best) {
+        if constexpr (IsClassicRules<Rules>) {
+            if (cache_)
+                cache_->insert(key, best);
+        }
+        return pickAmong(best, rng_);
+    };
+
+    if constexpr (IsClassicRules<Rules>) {
+        // Поиск сам учитывает попадания, поэтому список целей ему не нужен
+        // Зерно берётся до кэша: попадание в кэш не сдвигает
+        // последовательность rng_ для следующих ходов
+        if (search_) {
+            const auto seed = rng_();
+            if (auto best = cached(observed ^ SearchSalt))
+                return pickAmong(*best, rng_);
+
+            lastSearch_ = search_->run(playerBoard, shots, seed, cancel);
+            if (lastSearch_.valid)
+                return remember(observed ^ SearchSalt, Bitboard::cell(lastSearch_.best.x, lastSearch_.best.y));
+        }
+
+        // Апостериорная карта тоже учитывает попадания сама
+        if (monteCarlo_) {
+            const auto seed = rng_();
+            if (auto best = cached(observed ^ MonteCarloSalt))
+                return pickAmong(*best, rng_);
+
+            if (monteCarlo_->compute(playerBoard, seed))
+                return remember(observed ^ MonteCarloSalt, bestCells<Rules>(monteCarlo_->map, shots));
+        }
+    }
+    else {
+        (void)cancel;
+    }
 
-        std::uniform_int_distribution<size_t> dist(0, best.size() - 1);
-        chosen = best[dist(rng_)];
+    // Выведенная палуба — верное попадание, раньше любых целей
+    if (deductions_.forced.any()) {
+        const std::size_t index = deductions_.forced.lowest();
+        if (!shots[index / Rules::BoardSize][index % Rules::BoardSize])
+            return Coord(static_cast<int>(index % Rules::BoardSize), static_cast<int>(index / Rules::BoardSize));
     }
 
-    auto [tx, ty] = *chosen;
+    // Удаляем недействительные цели
+    erase_if(state_.targets, [&](const Coord& t) {
+        return !playerBoard.isInside(t.x, t.y) || shots[t.y][t.x];
+        });
+
+    // Если есть цели — берём последнюю
+    if (!state_.targets.empty()) {
+        const Coord chosen = state_.targets.back();
+        state_.targets.pop_back();
+        return chosen;
+    }
+
+    // Иначе — вероятностная карта без выведенной воды и затопленных длин.
+    // Она зависит только от видимого состояния, поэтому кэшируется; карта
+    // пропускает ходы из кэша и потом догоняет их одним update()
+    if (auto best = cached(observed))
+        return pickAmong(*best, rng_);
+
+    prob_.update(playerBoard, deductions_.blocked, state_.remaining);
+    return remember(observed, bestCells<Rules>(prob_.map, shots));
+}
+
+// ------------------------------------------------------------
+//  Выстрел в выбранную клетку
+// ------------------------------------------------------------
+template <class Rules>
+bool BasicAIController<Rules>::applyShot(
+    Coord target,
+    Board& playerBoard,
+    ShotsGrid& shots,
+    bool& playerTurn,
+    bool& playerWon
+) noexcept
+{
+    Profiler::count(ProfileCounter::AiShots);
+
+    auto [tx, ty] = target;
     shots[ty][tx] = true;
 
     ShotResult result = playerBoard.shoot(tx, ty);
@@ -284,5 +504,30 @@ bool AIController::takeTurn(
         break;
     }
 
+    applyDeductions(playerBoard, shots);
     return false;
 }
+
+// ------------------------------------------------------------
+//  Новая партия
+// ------------------------------------------------------------
+template <class Rules>
+void BasicAIController<Rules>::reset() noexcept
+{
+    // Карта вероятностей начнётся заново сама: у нового поля
+    // закрытых клеток меньше (см. ProbabilityMap::update)
+    state_.resetShipTracking();
+    state_.resetFleet();
+    deductions_ = {};
+    bookMoves_ = 0;
+
+    if (endgame_)
+        endgame_->reset();
+}
+
+// ------------------------------------------------------------
+//  Заранее собранные варианты правил
+// ------------------------------------------------------------
+#define RULES_INSTANTIATE(Rules, name) template class BasicAIController<Rules>;
+RULES_VARIANTS(RULES_INSTANTIATE)
+#undef RULES_INSTANTIATE
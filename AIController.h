@@ -1,19 +1,28 @@
 #pragma once
 
-#include <vector>
 #include <random>
 #include <optional>
 #include <array>
-#include <SFML/System/Vector2.hpp>
+#include <atomic>
+#include <memory>
 
 #include "Board.h"
 #include "ShotsGrid.h"
 #include "AIState.h"
+#include "ConstraintPropagation.h"
+#include "Coord.h"
 #include "ProbabilityMap.h"
+#include "ShotCache.h"
+#include "MonteCarloMap.h"
+#include "EndgameSolver.h"
+#include "LookaheadSearch.h"
 #include "GameConfig.h"
+#include "GameRules.h"
+
+class OpeningBook;
 
 /**
- * @class AIController
+ * @class BasicAIController
  * @brief       .
  *
  * :
@@ -22,10 +31,24 @@
  *  -     
  *  -   
  *  -       ( )
+ *  -       (ConstraintPropagation)
+ *  -     -    (MonteCarloMap)
+ *  -         (LookaheadSearch)
+ *  -      ,    (EndgameSolver)
+ *
+ *  -, ,  ,    
+ *    ClassicRules;     ProbabilityMap.
  */
-class AIController {
+template <class Rules>
+class BasicAIController {
 public:
-    explicit AIController(std::mt19937& rng) noexcept;
+    using Bitboard = typename Rules::Bitboard;
+    using Board = BasicBoard<Rules>;
+    using ShotsGrid = BasicShotsGrid<Rules::BoardSize>;
+    using Ship = BasicShip<Rules>;
+    using ProbabilityMap = BasicProbabilityMap<Rules>;
+
+    explicit BasicAIController(std::mt19937& rng) noexcept;
 
     /**
      * @brief   .
@@ -44,26 +67,188 @@ public:
         bool& playerWon
     ) noexcept;
 
+    /**
+     * @brief      (  takeTurn).
+     *
+     *   ,        
+     *  (AIWorker),    .
+     *
+     * @param cancel     (nullptr   );
+     *                     
+     */
+    [[nodiscard]]
+    Coord chooseShot(
+        const Board& playerBoard,
+        const ShotsGrid& shots,
+        const std::atomic<bool>* cancel = nullptr
+    ) noexcept;
+
+    /**
+     * @brief     (  takeTurn).
+     *
+     * @return true    
+     */
+    [[nodiscard]]
+    bool applyShot(
+        Coord target,
+        Board& playerBoard,
+        ShotsGrid& shots,
+        bool& playerTurn,
+        bool& playerWon
+    ) noexcept;
+
+    /**
+     * @brief     ( ).
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief        .
+     *
+     *        ,
+     *    .
+     */
+    void enableSearch(const SearchConfig& config)
+        requires IsClassicRules<Rules>;
+
+    /**
+     * @brief      .
+     */
+    void disableSearch() noexcept;
+
+    /**
+     * @brief   .
+     */
+    [[nodiscard]]
+    const SearchResult& lastSearch() const noexcept { return lastSearch_; }
+
+    /**
+     * @brief     -  ProbabilityMap.
+     *
+     *    ,    
+     *  .     ,
+     *    .
+     */
+    void enableMonteCarloMap(const MonteCarloConfig& config)
+        requires IsClassicRules<Rules>;
+
+    /**
+     * @brief  ProbabilityMap     .
+     */
+    void disableMonteCarloMap() noexcept;
+
+    /**
+     * @brief  - (nullptr  ); stats()   .
+     */
+    [[nodiscard]]
+    const MonteCarloMap* monteCarloMap() const noexcept { return monteCarlo_.get(); }
+
+    /**
+     * @brief     (  ).
+     *
+     *       
+     *    ,    .
+     */
+    void enableEndgameSolver(const EndgameConfig& config)
+        requires IsClassicRules<Rules>;
+
+    void disableEndgameSolver() noexcept;
+
+    /**
+     * @brief     .
+     */
+    [[nodiscard]]
+    const EndgameResult& lastEndgame() const noexcept { return lastEndgame_; }
+
+    /**
+     * @brief        (nullptr   ).
+     *
+     *          
+     *         .
+     *           .
+     *     -  :   
+     *    ,      
+     *   .
+     */
+    void setShotCache(ShotCache* cache) noexcept
+        requires IsClassicRules<Rules>;
+
+    /**
+     * @brief   (nullptr   ).
+     *
+     *        ;   
+     *       (battleship_book).  
+     *        .
+     */
+    void setOpeningBook(const OpeningBook* book) noexcept
+        requires IsClassicRules<Rules>;
+
+    /**
+     * @brief ,       reset().
+     */
+    [[nodiscard]]
+    int bookMoves() const noexcept { return bookMoves_; }
+
+    /**
+     * @brief       .
+     */
+    [[nodiscard]]
+    const ProbabilityMap& probabilityMap() const noexcept { return prob_; }
+
+    /**
+     * @brief        .
+     */
+    [[nodiscard]]
+    const typename Rules::Counts& remainingShips() const noexcept { return state_.remaining; }
+
 private:
     //    
     std::mt19937& rng_;
 
     //     (, ,  )
-    AIState state_;
+    BasicAIState<Rules> state_;
 
     //     
     ProbabilityMap prob_;
 
+    //      
+    BasicDeductions<Rules> deductions_;
+
+    //    ( )
+    ShotCache* cache_ = nullptr;
+
+    //   ( )    
+    const OpeningBook* book_ = nullptr;
+    int bookMoves_ = 0;
+
+    //    (nullptr  )
+    std::unique_ptr<EndgameSolver> endgame_;
+    EndgameResult lastEndgame_;
+
+    //  - (nullptr    prob_)
+    std::unique_ptr<MonteCarloMap> monteCarlo_;
+
+    //   (nullptr     )
+    std::unique_ptr<LookaheadSearch> search_;
+    SearchResult lastSearch_;
+
 private:
     /**
-     * @brief         .
+     * @brief  deductions_       .
+     */
+    void applyDeductions(
+        const Board& board,
+        ShotsGrid& shots
+    ) noexcept;
+
+    /**
+     * @brief          .
      *
      *   :       ,
-     *  8      .
+     *      .
      */
-    void markForbiddenAroundHit(
-        int x, int y,
-        const Board& board,
+    void markForbiddenAroundShip(
+        const Ship& ship,
         ShotsGrid& shots
     ) noexcept;
 
@@ -108,3 +293,9 @@ private:
         const ShotsGrid& shots
     ) noexcept;
 };
+
+#define RULES_EXTERN(Rules, name) extern template class BasicAIController<Rules>;
+RULES_VARIANTS(RULES_EXTERN)
+#undef RULES_EXTERN
+
+using AIController = BasicAIController<ClassicRules>;
@@ -1,16 +1,31 @@
 #pragma once
 
-#include <vector>
-#include <algorithm>
-#include <SFML/System/Vector2.hpp>
+#include "Bitboard.h"
+#include "Coord.h"
+#include "GameConfig.h"
+#include "GameRules.h"
+#include "InlineVector.h"
+
+//       ( ,   ,  )
+template <class Rules>
+using BasicCellList = InlineVector<Coord, Rules::Cells>;
+
+using CellList = BasicCellList<ClassicRules>;
 
 //      
-struct AIState {
+template <class Rules>
+struct BasicAIState {
+    using Bitboard = typename Rules::Bitboard;
+    using CellList = BasicCellList<Rules>;
+
     //    
-    std::vector<sf::Vector2i> targets;
+    CellList targets;
 
     // ,        
-    std::vector<sf::Vector2i> hitCells;
+    CellList hitCells;
+
+    //          O(1)
+    Bitboard hitMask;
 
     //    
     bool hasDirection = false;
@@ -19,16 +34,34 @@ struct AIState {
     int dx = 0;
     int dy = 0;
 
+    //       
+    typename Rules::Counts remaining = Rules::ShipCounts;
+
     //      
-    void addHit(const sf::Vector2i& p) noexcept {
-        if (std::find(hitCells.begin(), hitCells.end(), p) == hitCells.end())
-            hitCells.push_back(p);
+    void addHit(const Coord& p) noexcept {
+        const std::size_t index = Bitboard::indexOf(p.x, p.y);
+        if (hitMask.test(index))
+            return;
+        hitMask.set(index);
+        hitCells.push_back(p);
+    }
+
+    //    length
+    void markSunk(int length) noexcept {
+        if (length > 0 && length <= Rules::MaxShipLength && remaining[length] > 0)
+            --remaining[length];
+    }
+
+    //  :   
+    void resetFleet() noexcept {
+        remaining = Rules::ShipCounts;
     }
 
     //   
     void resetShipTracking() noexcept {
         targets.clear();
         hitCells.clear();
+        hitMask = {};
         hasDirection = false;
         dx = 0;
         dy = 0;
@@ -46,3 +79,5 @@ struct AIState {
         return !targets.empty();
     }
 };
+
+using AIState = BasicAIState<ClassicRules>;
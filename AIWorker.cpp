@@ -0,0 +1,98 @@
+﻿#include "AIWorker.h"
+
+// ------------------------------------------------------------
+//  Запуск и остановка потока
+// ------------------------------------------------------------
+AIWorker::AIWorker(AIController& ai)
+    : ai_(ai),
+    thread_([this] { loop(); })
+{
+}
+
+AIWorker::~AIWorker() {
+    cancel();
+    state_.store(State::Stop, std::memory_order_release);
+    state_.notify_all();
+    thread_.join();
+}
+
+// ------------------------------------------------------------
+//  Главный поток: отдать снимок
+// ------------------------------------------------------------
+bool AIWorker::request(const Board& playerBoard, const ShotsGrid& shots) noexcept {
+    if (state_.load(std::memory_order_acquire) != State::Idle)
+        return false;
+
+    board_ = playerBoard;
+    shots_ = shots;
+
+    state_.store(State::Pending, std::memory_order_release);
+    state_.notify_all();
+    return true;
+}
+
+// ------------------------------------------------------------
+//  Главный поток: забрать ответ
+// ------------------------------------------------------------
+std::optional<Coord> AIWorker::poll() noexcept {
+    State expected = State::Ready;
+    if (!state_.compare_exchange_strong(expected, State::Idle, std::memory_order_acquire))
+        return std::nullopt;
+    return result_;
+}
+
+bool AIWorker::busy() const noexcept {
+    return state_.load(std::memory_order_acquire) != State::Idle;
+}
+
+// ------------------------------------------------------------
+//  Главный поток: отмена
+// ------------------------------------------------------------
+void AIWorker::cancel() noexcept {
+    cancel_.store(true, std::memory_order_relaxed);
+
+    State current = state_.load(std::memory_order_acquire);
+    for (;;) {
+        if (current == State::Idle || current == State::Stop)
+            break;
+
+        if (current == State::Running) {
+            // Ждём, пока рабочий поток отпустит AIController
+            state_.wait(State::Running, std::memory_order_acquire);
+            current = state_.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // Pending или Ready: задачу можно просто выбросить
+        if (state_.compare_exchange_weak(current, State::Idle, std::memory_order_acquire))
+            break;
+    }
+
+    cancel_.store(false, std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------
+//  Рабочий поток
+// ------------------------------------------------------------
+void AIWorker::loop() noexcept {
+    for (;;) {
+        State current = state_.load(std::memory_order_acquire);
+
+        if (current == State::Stop)
+            return;
+
+        if (current != State::Pending) {
+            state_.wait(current, std::memory_order_acquire);
+            continue;
+        }
+
+        if (!state_.compare_exchange_strong(current, State::Running, std::memory_order_acquire))
+            continue;
+
+        if (!cancel_.load(std::memory_order_relaxed))
+            result_ = ai_.chooseShot(board_, shots_, &cancel_);
+
+        state_.store(State::Ready, std::memory_order_release);
+        state_.notify_all();
+    }
+}
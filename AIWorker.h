@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+#include "AIController.h"
+#include "Board.h"
+#include "Coord.h"
+#include "ShotsGrid.h"
+
+/**
+ * @class AIWorker
+ * @brief Фоновый поток, выбирающий ход ИИ.
+ *
+ * Главный поток отдаёт копию поля игрока и сетки выстрелов (request),
+ * а затем каждый кадр проверяет, готов ли ответ (poll). Передача
+ * снимка и результата идёт через одно атомарное состояние без мьютексов:
+ * пока задача у рабочего потока, главный поток не трогает ни снимок,
+ * ни AIController.
+ *
+ * Сам выстрел (AIController::applyShot) делает главный поток,
+ * когда заберёт ответ.
+ */
+class AIWorker {
+public:
+    explicit AIWorker(AIController& ai);
+    ~AIWorker();
+
+    AIWorker(const AIWorker&) = delete;
+    AIWorker& operator=(const AIWorker&) = delete;
+
+    /**
+     * @brief Отдаёт снимок поля рабочему потоку.
+     *
+     * @return false  Предыдущая задача ещё не забрана
+     */
+    bool request(const Board& playerBoard, const ShotsGrid& shots) noexcept;
+
+    /**
+     * @brief Забирает выбранную клетку, если она уже готова.
+     */
+    [[nodiscard]]
+    std::optional<Coord> poll() noexcept;
+
+    /**
+     * @brief Есть ли незабранная задача (считается или ждёт poll).
+     */
+    [[nodiscard]]
+    bool busy() const noexcept;
+
+    /**
+     * @brief Отменяет задачу: прерывает поиск (AIController::chooseShot
+     *        получает флаг отмены), ждёт, пока рабочий поток отпустит
+     *        AIController, и выбрасывает ответ.
+     *
+     * После возврата AIController снова принадлежит главному потоку
+     * (например, для AIController::reset).
+     */
+    void cancel() noexcept;
+
+private:
+    // Кто сейчас владеет снимком и ответом
+    enum class State : std::uint8_t {
+        Idle,       ///< главный поток (можно писать снимок)
+        Pending,    ///< снимок готов, рабочий поток его ещё не взял
+        Running,    ///< рабочий поток считает
+        Ready,      ///< ответ готов, ждёт poll
+        Stop        ///< рабочий поток должен завершиться
+    };
+
+    AIController& ai_;
+
+    // Снимок поля: пишет главный поток в Idle, читает рабочий в Running
+    Board board_;
+    ShotsGrid shots_{};
+
+    // Ответ: пишет рабочий поток в Running, читает главный после Ready
+    Coord result_;
+
+    std::atomic<State> state_{ State::Idle };
+    std::atomic<bool> cancel_{ false };
+
+    std::thread thread_;
+
+    void loop() noexcept;
+};
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <cstdint>
+
+/**
+ * @file AllocationCounter.h
+ * @brief Счётчик выделений памяти в текущем потоке.
+ *
+ * Сам счётчик — здесь, в ядре. AllocationCounter.cpp заменяет
+ * глобальные operator new/delete и увеличивает его на каждое
+ * выделение; этот файл собирается только в программу, которой нужен
+ * подсчёт (battleship_sim проверяет, что ход ИИ не выделяет память),
+ * а не в ядро. Без замены счётчик всегда 0.
+ */
+
+// Выделения памяти текущим потоком (ведёт замена из AllocationCounter.cpp)
+inline thread_local std::uint64_t threadAllocations = 0;
+
+/**
+ * @brief Сколько раз текущий поток выделял память с начала работы
+ *        (0, если в программе нет AllocationCounter.cpp).
+ */
+[[nodiscard]]
+inline std::uint64_t threadAllocationCount() noexcept {
+    return threadAllocations;
+}
+
+/**
+ * @class AllocationScope
+ * @brief Число выделений памяти в текущем потоке за время жизни объекта.
+ */
+class AllocationScope {
+public:
+    AllocationScope() noexcept : start_(threadAllocationCount()) {}
+
+    [[nodiscard]]
+    std::uint64_t count() const noexcept { return threadAllocationCount() - start_; }
+
+private:
+    std::uint64_t start_;
+};
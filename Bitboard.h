@@ -0,0 +1,265 @@
+﻿#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "GameConfig.h"
+
+/**
+ * @file Bitboard.h
+ * @brief Битовая маска клеток игрового поля.
+ *
+ * Клетке (x, y) соответствует бит с номером y * Width + x.
+ * Поле 10×10 укладывается в два 64-битных слова (128 бит),
+ * поэтому операции над всем полем сводятся к нескольким
+ * сдвигам, AND/OR и popcount.
+ */
+template <std::size_t Width, std::size_t Height>
+class BasicBitboard {
+public:
+    static constexpr std::size_t Cells = Width * Height;
+    static constexpr std::size_t Words = (Cells + 63) / 64;
+
+    constexpr BasicBitboard() noexcept = default;
+
+    // Маска из одной клетки по индексу
+    [[nodiscard]]
+    static constexpr BasicBitboard bit(std::size_t index) noexcept {
+        BasicBitboard b;
+        b.words_[index / 64] = std::uint64_t{ 1 } << (index % 64);
+        return b;
+    }
+
+    // Маска из одной клетки по координатам
+    [[nodiscard]]
+    static constexpr BasicBitboard cell(int x, int y) noexcept {
+        return bit(indexOf(x, y));
+    }
+
+    // Маска всех клеток поля
+    [[nodiscard]]
+    static constexpr BasicBitboard full() noexcept {
+        BasicBitboard b;
+        for (auto& w : b.words_)
+            w = ~std::uint64_t{ 0 };
+        b.words_[Words - 1] &= LastWordMask;
+        return b;
+    }
+
+    // Маска одного столбца
+    [[nodiscard]]
+    static constexpr BasicBitboard column(std::size_t x) noexcept {
+        BasicBitboard b;
+        for (std::size_t y = 0; y < Height; ++y)
+            b.set(y * Width + x);
+        return b;
+    }
+
+    // Маска из готовых 64-битных слов (биты за полем отбрасываются)
+    [[nodiscard]]
+    static constexpr BasicBitboard fromWords(const std::array<std::uint64_t, Words>& words) noexcept {
+        BasicBitboard b;
+        b.words_ = words;
+        b.words_[Words - 1] &= LastWordMask;
+        return b;
+    }
+
+    [[nodiscard]]
+    static constexpr std::size_t indexOf(int x, int y) noexcept {
+        return static_cast<std::size_t>(y) * Width + static_cast<std::size_t>(x);
+    }
+
+    // ------------------------------------------------------------
+    //  Доступ к отдельным битам
+    // ------------------------------------------------------------
+    [[nodiscard]]
+    constexpr bool test(std::size_t index) const noexcept {
+        return (words_[index / 64] >> (index % 64)) & 1u;
+    }
+
+    constexpr void set(std::size_t index) noexcept {
+        words_[index / 64] |= std::uint64_t{ 1 } << (index % 64);
+    }
+
+    constexpr void reset(std::size_t index) noexcept {
+        words_[index / 64] &= ~(std::uint64_t{ 1 } << (index % 64));
+    }
+
+    [[nodiscard]]
+    constexpr bool any() const noexcept {
+        for (auto w : words_)
+            if (w) return true;
+        return false;
+    }
+
+    [[nodiscard]]
+    constexpr bool none() const noexcept { return !any(); }
+
+    [[nodiscard]]
+    constexpr int count() const noexcept {
+        int n = 0;
+        for (auto w : words_)
+            n += std::popcount(w);
+        return n;
+    }
+
+    // Индекс младшего установленного бита (маска не должна быть пустой)
+    [[nodiscard]]
+    constexpr std::size_t lowest() const noexcept {
+        for (std::size_t i = 0; i < Words; ++i)
+            if (words_[i])
+                return i * 64 + static_cast<std::size_t>(std::countr_zero(words_[i]));
+        return Cells;
+    }
+
+    // Индекс k-го по счёту (с нуля) установленного бита, k < count()
+    [[nodiscard]]
+    constexpr std::size_t nth(int k) const noexcept {
+        for (std::size_t i = 0; i < Words; ++i) {
+            std::uint64_t w = words_[i];
+            const int n = std::popcount(w);
+            if (k >= n) {
+                k -= n;
+                continue;
+            }
+            for (; k > 0; --k)
+                w &= w - 1;
+            return i * 64 + static_cast<std::size_t>(std::countr_zero(w));
+        }
+        return Cells;
+    }
+
+    // Вызывает f(index) для каждого установленного бита по возрастанию
+    template <class F>
+    constexpr void forEach(F&& f) const {
+        for (std::size_t i = 0; i < Words; ++i) {
+            std::uint64_t w = words_[i];
+            while (w) {
+                f(i * 64 + static_cast<std::size_t>(std::countr_zero(w)));
+                w &= w - 1;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    constexpr const std::array<std::uint64_t, Words>& words() const noexcept { return words_; }
+
+    // ------------------------------------------------------------
+    //  Логические операции
+    // ------------------------------------------------------------
+    constexpr BasicBitboard& operator&=(const BasicBitboard& o) noexcept {
+        for (std::size_t i = 0; i < Words; ++i) words_[i] &= o.words_[i];
+        return *this;
+    }
+
+    constexpr BasicBitboard& operator|=(const BasicBitboard& o) noexcept {
+        for (std::size_t i = 0; i < Words; ++i) words_[i] |= o.words_[i];
+        return *this;
+    }
+
+    constexpr BasicBitboard& operator^=(const BasicBitboard& o) noexcept {
+        for (std::size_t i = 0; i < Words; ++i) words_[i] ^= o.words_[i];
+        return *this;
+    }
+
+    [[nodiscard]]
+    friend constexpr BasicBitboard operator&(BasicBitboard a, const BasicBitboard& b) noexcept { return a &= b; }
+
+    [[nodiscard]]
+    friend constexpr BasicBitboard operator|(BasicBitboard a, const BasicBitboard& b) noexcept { return a |= b; }
+
+    [[nodiscard]]
+    friend constexpr BasicBitboard operator^(BasicBitboard a, const BasicBitboard& b) noexcept { return a ^= b; }
+
+    // Дополнение в пределах поля (биты за полем остаются нулевыми)
+    [[nodiscard]]
+    constexpr BasicBitboard operator~() const noexcept {
+        BasicBitboard b;
+        for (std::size_t i = 0; i < Words; ++i) b.words_[i] = ~words_[i];
+        b.words_[Words - 1] &= LastWordMask;
+        return b;
+    }
+
+    [[nodiscard]]
+    friend constexpr bool operator==(const BasicBitboard&, const BasicBitboard&) noexcept = default;
+
+    // ------------------------------------------------------------
+    //  Сдвиги на одну клетку (клетки, ушедшие за край, пропадают)
+    // ------------------------------------------------------------
+    [[nodiscard]]
+    constexpr BasicBitboard east() const noexcept {   // x + 1
+        constexpr BasicBitboard mask = ~column(Width - 1);
+        return (*this & mask).shl(1);
+    }
+
+    [[nodiscard]]
+    constexpr BasicBitboard west() const noexcept {   // x - 1
+        constexpr BasicBitboard mask = ~column(0);
+        return (*this & mask).shr(1);
+    }
+
+    [[nodiscard]]
+    constexpr BasicBitboard south() const noexcept {  // y + 1
+        return shl(Width);
+    }
+
+    [[nodiscard]]
+    constexpr BasicBitboard north() const noexcept {  // y - 1
+        return shr(Width);
+    }
+
+    // Клетки маски вместе с соседями по 4 направлениям
+    [[nodiscard]]
+    constexpr BasicBitboard cross() const noexcept {
+        return *this | east() | west() | north() | south();
+    }
+
+    // Клетки маски вместе со всем окружением 3×3
+    [[nodiscard]]
+    constexpr BasicBitboard neighbourhood() const noexcept {
+        const BasicBitboard row = *this | east() | west();
+        return row | row.north() | row.south();
+    }
+
+private:
+    static constexpr std::uint64_t LastWordMask =
+        (Cells % 64 == 0) ? ~std::uint64_t{ 0 } : ((std::uint64_t{ 1 } << (Cells % 64)) - 1);
+
+    std::array<std::uint64_t, Words> words_{};
+
+    [[nodiscard]]
+    constexpr BasicBitboard shl(std::size_t n) const noexcept {
+        BasicBitboard b;
+        const std::size_t ws = n / 64;
+        const std::size_t bs = n % 64;
+
+        for (std::size_t i = Words; i-- > ws;) {
+            std::uint64_t w = words_[i - ws] << bs;
+            if (bs && i - ws > 0)
+                w |= words_[i - ws - 1] >> (64 - bs);
+            b.words_[i] = w;
+        }
+        b.words_[Words - 1] &= LastWordMask;
+        return b;
+    }
+
+    [[nodiscard]]
+    constexpr BasicBitboard shr(std::size_t n) const noexcept {
+        BasicBitboard b;
+        const std::size_t ws = n / 64;
+        const std::size_t bs = n % 64;
+
+        for (std::size_t i = 0; i + ws < Words; ++i) {
+            std::uint64_t w = words_[i + ws] >> bs;
+            if (bs && i + ws + 1 < Words)
+                w |= words_[i + ws + 1] << (64 - bs);
+            b.words_[i] = w;
+        }
+        return b;
+    }
+};
+
+// Маска поля текущей конфигурации игры
+using Bitboard = BasicBitboard<BOARD_SIZE, BOARD_SIZE>;
@@ -1,202 +1,289 @@
 ﻿#include "Board.h"
+#include "ShipPlacements.h"
+#include <cassert>
 #include <iostream>
 
 // ------------------------------------------------------------
 //  Конструктор
 // ------------------------------------------------------------
-Board::Board() {
+template <class Rules>
+BasicBoard<Rules>::BasicBoard() {
     reset();
 }
 
 // ------------------------------------------------------------
 //  Проверка выхода за границы
 // ------------------------------------------------------------
-bool Board::isInside(int x, int y) const noexcept {
-    return x >= 0 && x < static_cast<int>(BOARD_SIZE) &&
-        y >= 0 && y < static_cast<int>(BOARD_SIZE);
+template <class Rules>
+bool BasicBoard<Rules>::isInside(int x, int y) const noexcept {
+    return x >= 0 && x < Size &&
+        y >= 0 && y < Size;
 }
 
 // ------------------------------------------------------------
 //  Очистка поля
 // ------------------------------------------------------------
-void Board::reset() noexcept {
-    for (auto& row : cells_) {
-        row.fill(CellState::Empty);
-    }
-    shipsCellsTotal_ = 0;
-    shipsCellsHit_ = 0;
+template <class Rules>
+void BasicBoard<Rules>::reset() noexcept {
+    ships_ = {};
+    misses_ = {};
+    hits_ = {};
+    sunk_ = {};
+    forbidden_ = {};
+    observedHash_ = 0;
+
+    shipIds_.fill(NoShip);
+    shipCount_ = 0;
+    lastSunk_ = NoShip;
 }
 
 // ------------------------------------------------------------
-//  Проверка возможности поставить корабль
-//  Правило: корабли не соприкасаются ни сторонами, ни углами
+//  Zobrist-ключи видимых состояний клетки
 // ------------------------------------------------------------
-bool Board::canPlaceShip(int x, int y, int length, bool horizontal) const noexcept {
-    const int dx = horizontal ? 1 : 0;
-    const int dy = horizontal ? 0 : 1;
-
-    const int endX = x + dx * (length - 1);
-    const int endY = y + dy * (length - 1);
-
-    if (!isInside(endX, endY))
-        return false;
-
-    for (int i = 0; i < length; ++i) {
-        const int cx = x + dx * i;
-        const int cy = y + dy * i;
-
-        // Проверяем саму клетку и окружение 3×3
-        for (int ny = cy - 1; ny <= cy + 1; ++ny) {
-            for (int nx = cx - 1; nx <= cx + 1; ++nx) {
-                if (!isInside(nx, ny))
-                    continue;
-
-                if (cells_[ny][nx] == CellState::Ship)
-                    return false;
+namespace {
+    enum ObservedCell { ObservedMiss, ObservedHit, ObservedSunk, ObservedCells };
+
+    // Ключи постоянны (splitmix64 от фиксированного зерна), поэтому
+    // хеш одного и того же состояния одинаков во всех партиях и потоках
+    template <std::size_t Cells>
+    constexpr auto ZobristKeys = [] {
+        std::array<std::array<std::uint64_t, ObservedCells>, Cells> keys{};
+        std::uint64_t state = 0x243F6A8885A308D3ull;
+        for (auto& cell : keys) {
+            for (auto& key : cell) {
+                std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                key = z ^ (z >> 31);
             }
         }
-    }
-    return true;
+        return keys;
+    }();
+
 }
 
 // ------------------------------------------------------------
-//  Установка корабля (без дополнительной проверки)
+//  Проверка возможности поставить корабль
+//  Правило: корабли не соприкасаются ни сторонами, ни углами
 // ------------------------------------------------------------
-void Board::placeShip(int x, int y, int length, bool horizontal) noexcept {
-    const int dx = horizontal ? 1 : 0;
-    const int dy = horizontal ? 0 : 1;
-
-    for (int i = 0; i < length; ++i) {
-        const int cx = x + dx * i;
-        const int cy = y + dy * i;
-
-        cells_[cy][cx] = CellState::Ship;
-        ++shipsCellsTotal_;
-    }
+template <class Rules>
+bool BasicBoard<Rules>::canPlaceShip(int x, int y, int length, bool horizontal) const noexcept {
+    // forbidden_ уже содержит окружение 3×3 всех поставленных кораблей
+    const BasicShipPlacement<Rules>* placement = shipPlacementAt<Rules>(x, y, length, horizontal);
+    return placement && (placement->body & forbidden_).none();
 }
 
 // ------------------------------------------------------------
-//  Случайная расстановка флота
+//  Установка корабля (без дополнительной проверки)
 // ------------------------------------------------------------
-void Board::randomPlaceFleet(std::mt19937& rng) {
-    reset();
-
-    std::uniform_int_distribution<int> distXY(0, BOARD_SIZE - 1);
-    std::uniform_int_distribution<int> distDir(0, 1);
-
-    for (int len : SHIP_SIZES) {
-        bool placed = false;
-
-        for (int attempts = 0; attempts < 1000 && !placed; ++attempts) {
-            const int x = distXY(rng);
-            const int y = distXY(rng);
-            const bool horizontal = (distDir(rng) == 0);
-
-            if (canPlaceShip(x, y, len, horizontal)) {
-                placeShip(x, y, len, horizontal);
-                placed = true;
-            }
-        }
+template <class Rules>
+void BasicBoard<Rules>::placeShip(int x, int y, int length, bool horizontal) noexcept {
+    const BasicShipPlacement<Rules>& placement = *shipPlacementAt<Rules>(x, y, length, horizontal);
+    const Bitboard& body = placement.body;
+    const int id = shipCount_++;
+
+    fleet_[id] = Ship{ x, y, length, horizontal, body };
+    decksLeft_[id] = length;
+    body.forEach([&](std::size_t index) {
+        shipIds_[index] = static_cast<std::int8_t>(id);
+        });
+
+    ships_ |= body;
+    forbidden_ |= placement.halo;
+}
 
-        if (!placed) {
-            std::cerr << "Не удалось разместить корабль длины " << len << '\n';
-        }
-    }
+// ------------------------------------------------------------
+//  Снятие последнего поставленного корабля
+//  forbidden_ восстанавливает вызывающий (из сохранённой копии).
+// ------------------------------------------------------------
+template <class Rules>
+void BasicBoard<Rules>::removeLastShip() noexcept {
+    const int id = --shipCount_;
+    const Bitboard& body = fleet_[id].body;
+
+    body.forEach([&](std::size_t index) {
+        shipIds_[index] = NoShip;
+        });
+    ships_ &= ~body;
 }
 
 // ------------------------------------------------------------
-//  Проверка, затоплен ли корабль, к которому относится (x, y)
-//  Предполагается, что (x, y) - Hit либо только что Hit.
+//  Расстановка кораблей Rules::ShipSizes[shipIndex..] с возвратом
+//
+//  Допустимые начала корабля длины L считаются сразу для всего поля:
+//  клетка подходит, если она и L-1 следующих за ней (вправо или вниз)
+//  не задевают forbidden_. Случайное начало выбирается из этих масок;
+//  если дальше флот не расставляется, начало вычёркивается.
 // ------------------------------------------------------------
-bool Board::isShipSunk(int x, int y) const noexcept {
-    constexpr std::array<std::pair<int, int>, 4> dirs{
-        std::pair{ 1, 0 },
-        std::pair{-1, 0 },
-        std::pair{ 0, 1 },
-        std::pair{ 0,-1 }
-    };
+template <class Rules>
+bool BasicBoard<Rules>::placeFleetFrom(std::size_t shipIndex, std::mt19937& rng) noexcept {
+    if (shipIndex == Rules::ShipSizes.size())
+        return true;
+
+    const int length = Rules::ShipSizes[shipIndex];
+    const Bitboard free = ~forbidden_;
+
+    Bitboard startsH = free;
+    Bitboard startsV = free;
+    Bitboard shiftedH = free;
+    Bitboard shiftedV = free;
+
+    for (int i = 1; i < length; ++i) {
+        shiftedH = shiftedH.west();    // в клетке x — свобода клетки x + i
+        shiftedV = shiftedV.north();   // в клетке y — свобода клетки y + i
+        startsH &= shiftedH;
+        startsV &= shiftedV;
+    }
 
-    for (auto [dx, dy] : dirs) {
-        int nx = x;
-        int ny = y;
+    // Однопалубный корабль одинаков в обеих ориентациях
+    if (length == 1)
+        startsV = {};
 
-        while (isInside(nx, ny)) {
-            const auto st = cells_[ny][nx];
+    const Bitboard savedForbidden = forbidden_;
 
-            if (st == CellState::Ship)
-                return false;  // есть живая палуба
+    for (;;) {
+        const int countH = startsH.count();
+        const int total = countH + startsV.count();
+        if (total == 0)
+            return false;
 
-            if (st != CellState::Hit)
-                break;         // вышли за пределы корабля
+        std::uniform_int_distribution<int> dist(0, total - 1);
+        const int k = dist(rng);
 
-            nx += dx;
-            ny += dy;
-        }
+        const bool horizontal = k < countH;
+        Bitboard& starts = horizontal ? startsH : startsV;
+        const std::size_t index = starts.nth(horizontal ? k : k - countH);
+
+        placeShip(static_cast<int>(index % Rules::BoardSize), static_cast<int>(index / Rules::BoardSize),
+            length, horizontal);
+
+        if (placeFleetFrom(shipIndex + 1, rng))
+            return true;
+
+        removeLastShip();
+        forbidden_ = savedForbidden;
+        starts.reset(index);
     }
-    return true;
 }
 
 // ------------------------------------------------------------
-//  Пометить корабль как затопленный (все его палубы)
-//  Предполагается, что isShipSunk(x, y) == true.
+//  Случайная расстановка флота
 // ------------------------------------------------------------
-void Board::markShipSunk(int x, int y) noexcept {
-    constexpr std::array<std::pair<int, int>, 4> dirs{
-        std::pair{ 1, 0 },
-        std::pair{-1, 0 },
-        std::pair{ 0, 1 },
-        std::pair{ 0,-1 }
-    };
+template <class Rules>
+void BasicBoard<Rules>::randomPlaceFleet(std::mt19937& rng) {
+    reset();
 
-    cells_[y][x] = CellState::Sunk;
+    [[maybe_unused]] const bool placed = placeFleetFrom(0, rng);
+    assert(placed && "GameRules::FleetFits гарантирует расстановку");
+}
 
-    for (auto [dx, dy] : dirs) {
-        int nx = x + dx;
-        int ny = y + dy;
+// ------------------------------------------------------------
+//  Расстановка заданного флота
+// ------------------------------------------------------------
+template <class Rules>
+bool BasicBoard<Rules>::placeFleet(const Fleet& fleet) noexcept {
+    reset();
 
-        while (isInside(nx, ny) && cells_[ny][nx] == CellState::Hit) {
-            cells_[ny][nx] = CellState::Sunk;
-            nx += dx;
-            ny += dy;
+    for (const Ship& ship : fleet) {
+        if (ship.length < 1 || !canPlaceShip(ship.x, ship.y, ship.length, ship.horizontal)) {
+            reset();
+            return false;
         }
+        placeShip(ship.x, ship.y, ship.length, ship.horizontal);
     }
+    return true;
 }
 
 // ------------------------------------------------------------
 //  Выстрел по клетке
 // ------------------------------------------------------------
-ShotResult Board::shoot(int x, int y) noexcept {
+template <class Rules>
+ShotResult BasicBoard<Rules>::shoot(int x, int y) noexcept {
     if (!isInside(x, y))
         return ShotResult::Invalid;
 
-    auto& cell = cells_[y][x];
+    const std::size_t index = Bitboard::indexOf(x, y);
 
     // Повторный выстрел
-    if (isShot(cell))
+    if (misses_.test(index) || hits_.test(index))
         return ShotResult::Repeat;
 
     // Попадание
-    if (cell == CellState::Ship) {
-        cell = CellState::Hit;
-        ++shipsCellsHit_;
-
-        if (isShipSunk(x, y)) {
-            markShipSunk(x, y);
+    const int id = shipIds_[index];
+    if (id != NoShip) {
+        hits_.set(index);
+
+        // Последняя живая палуба — корабль затоплен: прежние попадания
+        // по нему меняют вид на «затоплено»
+        if (--decksLeft_[id] == 0) {
+            sunk_ |= fleet_[id].body;
+            lastSunk_ = id;
+
+            fleet_[id].body.forEach([&](std::size_t deck) {
+                if (deck != index)
+                    observedHash_ ^= ZobristKeys<Rules::Cells>[deck][ObservedHit];
+                observedHash_ ^= ZobristKeys<Rules::Cells>[deck][ObservedSunk];
+                });
             return ShotResult::Sunk;
         }
 
+        observedHash_ ^= ZobristKeys<Rules::Cells>[index][ObservedHit];
         return ShotResult::Hit;
     }
 
     // Промах
-    cell = CellState::Miss;
+    misses_.set(index);
+    observedHash_ ^= ZobristKeys<Rules::Cells>[index][ObservedMiss];
     return ShotResult::Miss;
 }
 
+// ------------------------------------------------------------
+//  Последний затопленный корабль
+// ------------------------------------------------------------
+template <class Rules>
+const BasicShip<Rules>* BasicBoard<Rules>::lastSunk() const noexcept {
+    return lastSunk_ == NoShip ? nullptr : &fleet_[lastSunk_];
+}
+
 // ------------------------------------------------------------
 //  Проверка уничтожения всего флота
 // ------------------------------------------------------------
-bool Board::allShipsDestroyed() const noexcept {
-    return shipsCellsTotal_ > 0 &&
-        shipsCellsHit_ == shipsCellsTotal_;
+template <class Rules>
+bool BasicBoard<Rules>::allShipsDestroyed() const noexcept {
+    return ships_.any() && (ships_ & ~hits_).none();
+}
+
+// ------------------------------------------------------------
+//  Состояние одной клетки
+// ------------------------------------------------------------
+template <class Rules>
+CellState BasicBoard<Rules>::cellAt(int x, int y) const noexcept {
+    const std::size_t index = Bitboard::indexOf(x, y);
+
+    if (sunk_.test(index))   return CellState::Sunk;
+    if (hits_.test(index))   return CellState::Hit;
+    if (misses_.test(index)) return CellState::Miss;
+    if (ships_.test(index))  return CellState::Ship;
+    return CellState::Empty;
 }
+
+// ------------------------------------------------------------
+//  Сетка поля, собранная из масок
+// ------------------------------------------------------------
+template <class Rules>
+typename BasicBoard<Rules>::Grid BasicBoard<Rules>::cells() const noexcept {
+    Grid grid{};
+
+    for (int y = 0; y < Size; ++y)
+        for (int x = 0; x < Size; ++x)
+            grid[y][x] = cellAt(x, y);
+
+    return grid;
+}
+
+// ------------------------------------------------------------
+//  Заранее собранные варианты правил
+// ------------------------------------------------------------
+#define RULES_INSTANTIATE(Rules, name) template class BasicBoard<Rules>;
+RULES_VARIANTS(RULES_INSTANTIATE)
+#undef RULES_INSTANTIATE
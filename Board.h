@@ -3,25 +3,44 @@
 #include <array>
 #include <random>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 
+#include "Bitboard.h"
 #include "CellState.h"
 #include "GameConfig.h"
+#include "GameRules.h"
+#include "Ship.h"
 #include "ShotResult.h"
 
-//  alias   
-using BoardGrid = std::array<std::array<CellState, BOARD_SIZE>, BOARD_SIZE>;
-
 /**
- * @class Board
- * @brief     .
+ * @class BasicBoard
+ * @brief        Rules (. GameRules.h).
  *
  *   ,  ,  
  *    .
+ *
+ *       (, ,
+ * ,  ),  ,  
+ *         .
+ *
+ *      ,     
+ *   :    O(1).
  */
-class Board {
+template <class Rules>
+class BasicBoard {
 public:
-    Board();
+    using Bitboard = typename Rules::Bitboard;
+    using Ship = BasicShip<Rules>;
+    using Fleet = BasicFleet<Rules>;
+
+    //  
+    using Grid = std::array<std::array<CellState, Rules::BoardSize>, Rules::BoardSize>;
+
+    //  
+    static constexpr int Size = static_cast<int>(Rules::BoardSize);
+
+    BasicBoard();
 
     /**
      * @brief   .
@@ -36,9 +55,21 @@ public:
 
     /**
      * @brief   .
+     *
+     *    :    
+     *     (  ),   
+     *    .    :  
+     * ,  GameRules::FleetFits.
      */
     void randomPlaceFleet(std::mt19937& rng);
 
+    /**
+     * @brief    (,  FleetSampler).
+     *
+     * @return false        ( ).
+     */
+    bool placeFleet(const Fleet& fleet) noexcept;
+
     /**
      * @brief   .
      *
@@ -47,6 +78,15 @@ public:
     [[nodiscard]]
     ShotResult shoot(int x, int y) noexcept;
 
+    /**
+     * @brief ,   .
+     *
+     *   ,  shoot()  ShotResult::Sunk,
+     *   reset().     nullptr.
+     */
+    [[nodiscard]]
+    const Ship* lastSunk() const noexcept;
+
     /**
      * @brief    .
      */
@@ -54,15 +94,59 @@ public:
     bool allShipsDestroyed() const noexcept;
 
     /**
-     * @brief    .
+     * @brief   .
      */
     [[nodiscard]]
-    const BoardGrid& cells() const noexcept { return cells_; }
+    CellState cellAt(int x, int y) const noexcept;
+
+    /**
+     * @brief  ,     ( ).
+     */
+    [[nodiscard]]
+    Grid cells() const noexcept;
+
+    /**
+     * @brief    .
+     */
+    [[nodiscard]]
+    const Bitboard& ships() const noexcept { return ships_; }
+
+    [[nodiscard]]
+    const Bitboard& misses() const noexcept { return misses_; }
+
+    [[nodiscard]]
+    const Bitboard& hits() const noexcept { return hits_; }
+
+    [[nodiscard]]
+    const Bitboard& sunk() const noexcept { return sunk_; }
+
+    /**
+     * @brief Zobrist- ,   : ,
+     *            (  ).
+     *
+     *   shoot()  O(1)   (   
+     * );      
+     *   .
+     */
+    [[nodiscard]]
+    std::uint64_t observedHash() const noexcept { return observedHash_; }
 
 private:
-    BoardGrid cells_{};          ///<  
-    int shipsCellsTotal_ = 0;    ///<   
-    int shipsCellsHit_ = 0;      ///<   
+    Bitboard ships_;       ///<  
+    Bitboard misses_;      ///< 
+    Bitboard hits_;        ///<  (  )
+    Bitboard sunk_;        ///<   
+    Bitboard forbidden_;   ///<     3x3
+    std::uint64_t observedHash_ = 0;   ///< . observedHash()
+
+    //     shipIds_
+    static constexpr std::int8_t NoShip = -1;
+
+    Fleet fleet_{};                                  ///<  
+    std::array<int, Rules::ShipSizes.size()> decksLeft_{};  ///<    
+    std::array<std::int8_t, Rules::Cells> shipIds_{};  ///<     
+    int shipCount_ = 0;                              ///<   
+    int lastSunk_ = NoShip;                          ///<   
 
     /**
      * @brief    .
@@ -78,13 +162,21 @@ private:
     void placeShip(int x, int y, int length, bool horizontal) noexcept;
 
     /**
-     * @brief ,   .
+     * @brief     ( forbidden_).
      */
-    [[nodiscard]]
-    bool isShipSunk(int x, int y) const noexcept;
+    void removeLastShip() noexcept;
 
     /**
-     * @brief     .
+     * @brief   Rules::ShipSizes   shipIndex ( ).
      */
-    void markShipSunk(int x, int y) noexcept;
+    [[nodiscard]]
+    bool placeFleetFrom(std::size_t shipIndex, std::mt19937& rng) noexcept;
 };
+
+#define RULES_EXTERN(Rules, name) extern template class BasicBoard<Rules>;
+RULES_VARIANTS(RULES_EXTERN)
+#undef RULES_EXTERN
+
+//   
+using Board = BasicBoard<ClassicRules>;
+using BoardGrid = Board::Grid;
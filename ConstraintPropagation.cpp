@@ -0,0 +1,171 @@
+﻿#include "ConstraintPropagation.h"
+
+#include <array>
+
+#include "Ship.h"
+
+namespace {
+
+    // Сдвиги вдоль оси корабля: ahead()[i] — клетка i + 1 вдоль оси,
+    // behind()[i] — клетка i - 1, sides() — соседи поперёк оси
+    template <class Rules, bool Horizontal>
+    struct Axis {
+        using Bitboard = typename Rules::Bitboard;
+
+        static constexpr std::size_t Step = Horizontal ? 1 : Rules::BoardSize;
+
+        static constexpr Bitboard ahead(const Bitboard& b) noexcept { return Horizontal ? b.west() : b.north(); }
+        static constexpr Bitboard behind(const Bitboard& b) noexcept { return Horizontal ? b.east() : b.south(); }
+        static constexpr Bitboard sides(const Bitboard& b) noexcept {
+            return Horizontal ? (b.north() | b.south()) : (b.east() | b.west());
+        }
+
+        // Номер клетки вдоль оси (столбец или строка)
+        static constexpr std::size_t along(std::size_t index) noexcept {
+            return Horizontal ? index % Rules::BoardSize : index / Rules::BoardSize;
+        }
+    };
+
+    // Первые палубы допустимых положений длины len вдоль оси
+    template <class Rules, bool Horizontal, class Bitboard = typename Rules::Bitboard>
+    Bitboard starts(int len, const Bitboard& free, const Bitboard& ships, const Bitboard& openHits) noexcept {
+        using A = Axis<Rules, Horizontal>;
+
+        // Палуба не стоит вплотную поперёк оси к чужой палубе
+        const Bitboard deck = free & ~A::sides(ships);
+
+        Bitboard result = deck & ~A::behind(ships);   // перед кораблём не палуба
+        Bitboard allHits = openHits;
+        Bitboard run = deck;
+        Bitboard hitRun = openHits;
+        Bitboard after = ships;
+
+        for (int k = 1; k < len; ++k) {
+            run = A::ahead(run);
+            hitRun = A::ahead(hitRun);
+            after = A::ahead(after);
+            result &= run;
+            allHits &= hitRun;
+        }
+        result &= ~A::ahead(after);                   // за кораблём не палуба
+        return result & ~allHits;                     // целиком на попаданиях — был бы затоплен
+    }
+
+    // Клетки, покрытые положениями с первыми палубами start
+    template <class Rules, bool Horizontal, class Bitboard = typename Rules::Bitboard>
+    Bitboard cover(int len, const Bitboard& start) noexcept {
+        Bitboard result = start;
+        Bitboard run = start;
+        for (int k = 1; k < len; ++k) {
+            run = Axis<Rules, Horizontal>::behind(run);
+            result |= run;
+        }
+        return result;
+    }
+
+    // Пересечение с положениями через клетку cell; false — таких нет
+    template <class Rules, bool Horizontal, class Bitboard = typename Rules::Bitboard>
+    bool intersectThrough(std::size_t cell, int len, const Bitboard& start, Bitboard& common) noexcept {
+        using A = Axis<Rules, Horizontal>;
+        bool found = false;
+
+        for (int k = 0; k < len && static_cast<std::size_t>(k) <= A::along(cell); ++k) {
+            const std::size_t first = cell - static_cast<std::size_t>(k) * A::Step;
+            if (!start.test(first))
+                continue;
+
+            Bitboard body;
+            for (int i = 0; i < len; ++i)
+                body.set(first + static_cast<std::size_t>(i) * A::Step);
+            common &= body;
+            found = true;
+        }
+        return found;
+    }
+
+    // Диагональные соседи клеток маски
+    template <class Bitboard>
+    constexpr Bitboard diagonals(const Bitboard& b) noexcept {
+        const Bitboard row = b.east() | b.west();
+        return row.north() | row.south();
+    }
+
+} // namespace
+
+// ------------------------------------------------------------
+// Распространение до неподвижной точки
+// ------------------------------------------------------------
+template <class Rules>
+BasicDeductions<Rules> propagateConstraints(const BasicBoard<Rules>& board) noexcept {
+    using Bitboard = typename Rules::Bitboard;
+
+    const Bitboard shot = board.misses() | board.hits();
+    const Bitboard openHits = board.hits() & ~board.sunk();
+    const Bitboard closed = board.misses() | board.sunk().neighbourhood();
+
+    // Различные длины оставшихся кораблей
+    const BasicShipLengths<Rules> remaining = remainingShipLengths<Rules>(board.sunk());
+    BasicShipLengths<Rules> lengths;
+    for (int len : remaining)
+        if (lengths.empty() || lengths.back() != len)
+            lengths.push_back(len);
+
+    BasicDeductions<Rules> d;
+    d.ships = openHits;
+
+    for (;;) {
+        ++d.rounds;
+        d.water |= diagonals(d.ships) & ~closed & ~shot;
+        d.blocked = closed | d.water;
+        const Bitboard free = ~d.blocked;
+
+        std::array<Bitboard, Rules::ShipSizes.size()> horizontal{};
+        std::array<Bitboard, Rules::ShipSizes.size()> vertical{};
+        Bitboard covered;
+
+        for (std::size_t i = 0; i < lengths.size(); ++i) {
+            const int len = lengths[i];
+            horizontal[i] = starts<Rules, true>(len, free, d.ships, openHits);
+            covered |= cover<Rules, true>(len, horizontal[i]);
+
+            // Однопалубный в обеих ориентациях — одно положение
+            if (len > 1) {
+                vertical[i] = starts<Rules, false>(len, free, d.ships, openHits);
+                covered |= cover<Rules, false>(len, vertical[i]);
+            }
+        }
+
+        // Клетки, где корабль есть во всех положениях через попадание
+        Bitboard forced;
+        openHits.forEach([&](std::size_t hit) {
+            Bitboard common = ~Bitboard{};
+            bool found = false;
+            for (std::size_t i = 0; i < lengths.size(); ++i) {
+                found |= intersectThrough<Rules, true>(hit, lengths[i], horizontal[i], common);
+                if (lengths[i] > 1)
+                    found |= intersectThrough<Rules, false>(hit, lengths[i], vertical[i], common);
+            }
+            if (found)
+                forced |= common;
+            });
+        forced &= ~shot;
+
+        const Bitboard water = d.water | (free & ~covered & ~shot);
+        if (water == d.water && (forced & ~d.forced).none()) {
+            d.blocked = closed | d.water;
+            return d;
+        }
+
+        d.water = water;
+        d.forced |= forced;
+        d.ships = openHits | d.forced;
+    }
+}
+
+// ------------------------------------------------------------
+// Заранее собранные варианты правил
+// ------------------------------------------------------------
+#define RULES_INSTANTIATE(Rules, name) \
+    template BasicDeductions<Rules> propagateConstraints(const BasicBoard<Rules>&) noexcept;
+RULES_VARIANTS(RULES_INSTANTIATE)
+#undef RULES_INSTANTIATE
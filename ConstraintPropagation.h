@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "Bitboard.h"
+#include "Board.h"
+
+/**
+ * @struct BasicDeductions
+ * @brief Что следует из видимых ИИ масок поля.
+ */
+template <class Rules>
+struct BasicDeductions {
+    using Bitboard = typename Rules::Bitboard;
+
+    Bitboard blocked;   ///< закрыто для оставшихся кораблей: промахи, затопленные с окружением, water
+    Bitboard ships;     ///< палубы оставшихся кораблей: открытые попадания и forced
+    Bitboard water;     ///< клетки без выстрела, где корабля заведомо нет
+    Bitboard forced;    ///< клетки без выстрела, где корабль заведомо есть
+    int rounds = 0;     ///< проходов до неподвижной точки
+};
+
+/**
+ * @brief Распространение ограничений по маскам поля.
+ *
+ * Из поля берутся только видимые ИИ маски. Правила:
+ *  - клетки по диагонали от палубы (попадания или forced) — вода:
+ *    корабли не касаются углами, а по диагонали корабль не идёт;
+ *  - клетка, которую не покрывает ни одно допустимое положение
+ *    ни одного оставшегося корабля, — вода. Допустимое положение
+ *    не задевает закрытых клеток, не касается чужих палуб и не лежит
+ *    целиком на попаданиях (такой корабль был бы уже затоплен);
+ *  - клетки, общие для всех допустимых положений через открытое
+ *    попадание, — палубы (попадание чьё-то, а другого корабля там нет).
+ * Новая вода и новые палубы сужают положения, поэтому правила
+ * повторяются до неподвижной точки. Положения считаются сразу для
+ * всего поля сдвигами масок, по одной маске на длину и ориентацию.
+ */
+template <class Rules>
+[[nodiscard]]
+BasicDeductions<Rules> propagateConstraints(const BasicBoard<Rules>& board) noexcept;
+
+#define RULES_EXTERN(Rules, name) \
+    extern template BasicDeductions<Rules> propagateConstraints(const BasicBoard<Rules>&) noexcept;
+RULES_VARIANTS(RULES_EXTERN)
+#undef RULES_EXTERN
+
+using Deductions = BasicDeductions<ClassicRules>;
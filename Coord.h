@@ -0,0 +1,16 @@
+﻿#pragma once
+
+/**
+ * @file Coord.h
+ * @brief Координаты клетки поля (без зависимости от SFML).
+ */
+struct Coord {
+    int x = 0;
+    int y = 0;
+
+    constexpr Coord() noexcept = default;
+    constexpr Coord(int x, int y) noexcept : x(x), y(y) {}
+
+    [[nodiscard]]
+    friend constexpr bool operator==(const Coord&, const Coord&) noexcept = default;
+};
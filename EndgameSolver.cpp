@@ -0,0 +1,334 @@
+﻿#include "EndgameSolver.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "PosteriorSampler.h"
+#include "ShipPlacements.h"
+
+namespace {
+
+    constexpr std::size_t Cells = Bitboard::Cells;
+
+    // Исходы выстрела (ключ группы расстановок)
+    constexpr std::uint32_t MissKey = 0;
+    constexpr std::uint32_t HitKey = 1;
+
+    // Затопление: какой именно корабль (первая палуба, длина, ориентация)
+    // и закончилась ли партия
+    constexpr std::uint32_t sunkKey(const Bitboard& body, bool gameOver) noexcept {
+        const auto first = static_cast<std::uint32_t>(body.lowest());
+        const auto length = static_cast<std::uint32_t>(body.count());
+        const std::uint32_t horizontal = length > 1 && body.test(first + 1) ? 1u : 0u;
+        return 2u + (gameOver ? 1u : 0u) + 2u * ((first * (MAX_SHIP_LENGTH + 1) + length) * 2u + horizontal);
+    }
+
+    constexpr bool isGameOver(std::uint32_t key) noexcept {
+        return key >= 2 && (key & 1u);
+    }
+
+} // namespace
+
+std::size_t EndgameSolver::KeyHash::operator()(const Key& key) const noexcept {
+    std::uint64_t h = key.subset;
+    for (std::uint64_t w : key.shot.words())
+        h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(h ^ (h >> 29));
+}
+
+// ------------------------------------------------------------
+// Конструктор и сброс
+// ------------------------------------------------------------
+EndgameSolver::EndgameSolver(const EndgameConfig& config)
+    : config_(config)
+{
+    // Номер расстановки хранится в 16 битах
+    config_.maxConfigurations = std::min<std::size_t>(config_.maxConfigurations, std::numeric_limits<std::uint16_t>::max());
+}
+
+void EndgameSolver::reset() noexcept {
+    configs_.clear();
+    zobrist_.clear();
+    table_.clear();
+    baseSunk_ = {};
+    lastMisses_ = {};
+    lastHits_ = {};
+}
+
+// ------------------------------------------------------------
+// Перебор согласованных расстановок
+// ------------------------------------------------------------
+bool EndgameSolver::enumerate(const Board& board) {
+    reset();
+    baseSunk_ = board.sunk();
+
+    const PosteriorSampler observed(board);
+    const ShipLengths& lengths = observed.remaining();
+    const Bitboard& openHits = observed.openHits();
+
+    // Сколько палуб ещё можно поставить начиная с корабля i
+    std::array<int, SHIP_SIZES.size() + 1> decksFrom{};
+    for (std::size_t i = lengths.size(); i-- > 0;)
+        decksFrom[i] = decksFrom[i + 1] + lengths[i];
+
+    std::uint64_t nodes = 0;
+    bool overflow = false;
+    Configuration current;
+
+    auto dfs = [&](auto& self, std::size_t ship, std::size_t from, const Bitboard& blocked) -> void {
+        const Bitboard uncovered = openHits & ~current.ships;
+        if (uncovered.count() > decksFrom[ship])
+            return;
+
+        if (ship == lengths.size()) {
+            if (configs_.size() == config_.maxConfigurations) {
+                overflow = true;
+                return;
+            }
+            configs_.push_back(current);
+            return;
+        }
+
+        const int len = lengths[ship];
+        const std::span<const ShipPlacement> placements = shipPlacements(len);
+
+        // Одинаковые корабли — по возрастанию номера положения
+        const std::size_t start = (ship > 0 && lengths[ship - 1] == len) ? from : 0;
+
+        for (std::size_t k = start; k < placements.size() && !overflow; ++k) {
+            if (++nodes > config_.maxEnumerationNodes) {
+                overflow = true;
+                return;
+            }
+
+            const ShipPlacement& p = placements[k];
+            if ((p.body & blocked).any() || (p.ring & openHits).any() || (p.body & ~openHits).none())
+                continue;
+
+            const Bitboard ships = current.ships;
+            current.ships |= p.body;
+            current.bodies.push_back(p.body);
+
+            self(self, ship + 1, k + 1, blocked | p.halo);
+
+            current.bodies.pop_back();
+            current.ships = ships;
+        }
+    };
+    dfs(dfs, 0, 0, observed.blocked());
+
+    if (overflow || configs_.empty()) {
+        configs_.clear();
+        return false;
+    }
+
+    std::mt19937_64 rng(configs_.size());
+    zobrist_.resize(configs_.size());
+    for (auto& z : zobrist_)
+        z = rng();
+    return true;
+}
+
+// ------------------------------------------------------------
+// Согласуется ли расстановка с новыми наблюдениями
+// ------------------------------------------------------------
+bool EndgameSolver::consistent(const Configuration& c, const Board& board) const noexcept {
+    if ((c.ships & board.misses()).any())
+        return false;
+    if ((board.hits() & ~baseSunk_ & ~c.ships).any())
+        return false;
+
+    // Корабль затоплен ровно тогда, когда подбиты все его палубы
+    for (const Bitboard& body : c.bodies) {
+        const bool allHit = (body & ~board.hits()).none();
+        const bool sunk = (body & ~board.sunk()).none();
+        if (allHit != sunk)
+            return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Ход решателя
+// ------------------------------------------------------------
+EndgameResult EndgameSolver::solve(const Board& board) {
+    EndgameResult result;
+    nodes_ = 0;
+    aborted_ = false;
+
+    // Наблюдения только растут; если нет — это новое поле
+    const bool continuation = !configs_.empty() &&
+        (lastMisses_ & ~board.misses()).none() &&
+        (lastHits_ & ~board.hits()).none() &&
+        (baseSunk_ & ~board.sunk()).none();
+
+    Subset subset;
+    if (continuation) {
+        for (std::size_t i = 0; i < configs_.size(); ++i)
+            if (consistent(configs_[i], board))
+                subset.push_back(static_cast<std::uint16_t>(i));
+    }
+
+    if (subset.empty()) {
+        if (!enumerate(board))
+            return result;
+        for (std::size_t i = 0; i < configs_.size(); ++i)
+            subset.push_back(static_cast<std::uint16_t>(i));
+    }
+
+    lastMisses_ = board.misses();
+    lastHits_ = board.hits();
+
+    std::uint64_t hash = 0;
+    for (std::uint16_t i : subset)
+        hash ^= zobrist_[i];
+
+    std::size_t best = Cells;
+    const double value = expected(subset, hash, board.misses() | board.hits(), &best);
+
+    result.configurations = subset.size();
+    result.nodes = nodes_;
+    result.tableSize = table_.size();
+    if (aborted_ || best == Cells)
+        return result;
+
+    result.solved = true;
+    result.best = Coord(static_cast<int>(best % BOARD_SIZE), static_cast<int>(best / BOARD_SIZE));
+    result.expectedShots = value;
+    return result;
+}
+
+// ------------------------------------------------------------
+// Ожидаемое число выстрелов до конца партии
+//
+// Во всех расстановках множества одинаково неподбитых палуб (decks),
+// и каждую придётся подбить, поэтому ответ — decks плюс ожидаемое
+// число промахов. Отсюда граница выстрела в клетку: 1 + decks - p,
+// где p — доля расстановок с кораблём в клетке; кандидаты
+// перебираются по убыванию p.
+//
+// bestCell != nullptr — корень: таблица не читается, нужен сам выстрел.
+// ------------------------------------------------------------
+double EndgameSolver::expected(const Subset& subset, std::uint64_t hash, const Bitboard& shot, std::size_t* bestCell) {
+    Bitboard ships;
+    std::array<std::uint16_t, Cells> occupied{};
+    for (std::uint16_t i : subset) {
+        ships |= configs_[i].ships;
+        (configs_[i].ships & ~shot).forEach([&](std::size_t cell) { ++occupied[cell]; });
+    }
+
+    const Key key{ shot & ships, hash };
+    if (!bestCell) {
+        const auto it = table_.find(key);
+        if (it != table_.end())
+            return it->second;
+    }
+
+    if (++nodes_ > config_.maxNodes) {
+        aborted_ = true;
+        return 0.0;
+    }
+
+    const auto total = static_cast<std::uint16_t>(subset.size());
+    const int decks = (configs_[subset.front()].ships & ~shot).count();
+
+    // Кандидаты по убыванию доли расстановок с кораблём в клетке.
+    // Клетка, занятая во всех расстановках, — единственный кандидат.
+    InlineVector<std::pair<std::uint16_t, std::uint16_t>, Cells> candidates;   // (-занято, клетка)
+    for (std::size_t cell = 0; cell < Cells; ++cell)
+        if (occupied[cell])
+            candidates.emplace_back(static_cast<std::uint16_t>(total - occupied[cell]), static_cast<std::uint16_t>(cell));
+    std::sort(candidates.begin(), candidates.end());
+    if (!candidates.empty() && candidates.front().first == 0) {
+        const auto certain = candidates.front();
+        candidates.clear();
+        candidates.push_back(certain);
+    }
+
+    // Группа расстановок с одинаковым исходом выстрела
+    struct Group {
+        std::uint32_t key = 0;
+        Subset members;
+        std::uint64_t hash = 0;
+        double bound = 0.0;      ///< нижняя граница ожидаемых выстрелов после выстрела
+    };
+    std::vector<Group> groups;
+
+    double best = std::numeric_limits<double>::infinity();
+    std::size_t bestAt = Cells;
+
+    for (const auto& [empty, cell16] : candidates) {
+        const std::size_t cell = cell16;
+        const double p = static_cast<double>(total - empty) / total;
+        if (1.0 + decks - p >= best)
+            break;
+
+        // Разбиение по исходу выстрела
+        groups.clear();
+        const Bitboard after = shot | Bitboard::bit(cell);
+        for (std::uint16_t i : subset) {
+            const Configuration& c = configs_[i];
+
+            std::uint32_t outcome = MissKey;
+            if (c.ships.test(cell)) {
+                outcome = HitKey;
+                for (const Bitboard& body : c.bodies) {
+                    if (body.test(cell)) {
+                        if ((body & ~after).none())
+                            outcome = sunkKey(body, decks == 1);
+                        break;
+                    }
+                }
+            }
+
+            auto g = std::find_if(groups.begin(), groups.end(), [&](const Group& x) { return x.key == outcome; });
+            if (g == groups.end()) {
+                groups.push_back(Group{ outcome, {}, 0, 0.0 });
+                g = groups.end() - 1;
+            }
+            g->members.push_back(i);
+            g->hash ^= zobrist_[i];
+        }
+
+        // Граница группы: оставшиеся палубы плюс вероятность промаха
+        // следующим выстрелом, если ни одна клетка не занята наверняка
+        double value = 1.0;
+        for (Group& g : groups) {
+            if (isGameOver(g.key))
+                continue;
+
+            std::array<std::uint16_t, Cells> counts{};
+            std::uint16_t most = 0;
+            for (std::uint16_t i : g.members)
+                (configs_[i].ships & ~after).forEach([&](std::size_t c) { most = std::max(most, ++counts[c]); });
+
+            const double size = static_cast<double>(g.members.size());
+            g.bound = (g.key == MissKey ? decks : decks - 1) + (size - most) / size;
+            value += size / total * g.bound;
+        }
+
+        // Границы по одной заменяются точными значениями
+        for (const Group& g : groups) {
+            if (value >= best)
+                break;
+            if (isGameOver(g.key))
+                continue;
+
+            const double e = expected(g.members, g.hash, after, nullptr);
+            if (aborted_)
+                return 0.0;
+            value += static_cast<double>(g.members.size()) / total * (e - g.bound);
+        }
+
+        if (value < best) {
+            best = value;
+            bestAt = cell;
+        }
+    }
+
+    table_.emplace(key, best);
+    if (bestCell)
+        *bestCell = bestAt;
+    return best;
+}
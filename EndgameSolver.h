@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Bitboard.h"
+#include "Board.h"
+#include "Coord.h"
+#include "GameConfig.h"
+#include "InlineVector.h"
+
+/**
+ * @struct EndgameConfig
+ * @brief Пороги точного решателя.
+ */
+struct EndgameConfig {
+    std::size_t maxConfigurations = 24;         ///< решать, если согласованных расстановок не больше
+    std::uint64_t maxEnumerationNodes = 50000;  ///< бюджет перебора расстановок за ход
+    std::uint64_t maxNodes = 20000;             ///< бюджет новых состояний решателя за ход
+};
+
+/**
+ * @struct EndgameResult
+ * @brief Ответ решателя.
+ */
+struct EndgameResult {
+    Coord best;
+    bool solved = false;              ///< ответ оптимален (иначе — выбирать обычным способом)
+    std::size_t configurations = 0;   ///< согласованных расстановок (0 — больше порога)
+    double expectedShots = 0.0;       ///< ожидаемое число выстрелов до конца партии
+    std::uint64_t nodes = 0;          ///< новых состояний за этот ход
+    std::size_t tableSize = 0;        ///< состояний в таблице транспозиций
+};
+
+/**
+ * @class EndgameSolver
+ * @brief Точный выбор выстрела, когда согласованных расстановок мало.
+ *
+ * Перебирает все расстановки оставшихся кораблей, согласованные
+ * с видимыми ИИ масками (одинаковые корабли — в порядке возрастания
+ * номера положения, чтобы не считать перестановки), с отсечениями
+ * по маскам. Если их не больше порога, ищет стратегию с наименьшим
+ * ожидаемым числом выстрелов до конца партии: все расстановки
+ * равновероятны, выстрел делит их по исходу (промах, попадание,
+ * затопление конкретного корабля, конец партии).
+ *
+ * Отсечения:
+ *  - клетка, занятая во всех расстановках, бьётся сразу (её всё равно
+ *    придётся бить, а раньше — значит с лишней информацией);
+ *  - ветви и границы: каждая оставшаяся палуба — минимум один выстрел,
+ *    а если ни одна клетка не занята наверняка, добавляется вероятность
+ *    промаха лучшим следующим выстрелом.
+ *
+ * Состояния (множество расстановок + выстрелы по их палубам)
+ * запоминаются в таблице транспозиций. Расстановки перебираются один
+ * раз за партию и дальше только фильтруются по новым наблюдениям,
+ * поэтому их номера и таблица переживают ходы.
+ */
+class EndgameSolver {
+public:
+    explicit EndgameSolver(const EndgameConfig& config = {});
+
+    /**
+     * @brief Лучший выстрел по видимым ИИ маскам поля.
+     */
+    [[nodiscard]]
+    EndgameResult solve(const Board& board);
+
+    /**
+     * @brief Забывает расстановки и таблицу (новая партия).
+     */
+    void reset() noexcept;
+
+    [[nodiscard]]
+    const EndgameConfig& config() const noexcept { return config_; }
+
+private:
+    // Одна согласованная расстановка оставшихся кораблей
+    struct Configuration {
+        Bitboard ships;
+        InlineVector<Bitboard, SHIP_SIZES.size()> bodies;
+    };
+
+    // Номера расстановок, совместимых с наблюдениями
+    using Subset = std::vector<std::uint16_t>;
+
+    // Ключ таблицы: выстрелы по палубам расстановок и хеш множества расстановок
+    struct Key {
+        Bitboard shot;
+        std::uint64_t subset = 0;
+
+        [[nodiscard]]
+        friend bool operator==(const Key&, const Key&) noexcept = default;
+    };
+
+    struct KeyHash {
+        [[nodiscard]]
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    EndgameConfig config_;
+
+    std::vector<Configuration> configs_;     ///< все расстановки с начала перебора
+    std::vector<std::uint64_t> zobrist_;     ///< случайный ключ каждой расстановки
+    bool overflow_ = false;                  ///< расстановок было больше порога
+
+    // Наблюдения, по которым шёл перебор и последняя фильтрация
+    Bitboard baseSunk_;
+    Bitboard lastMisses_;
+    Bitboard lastHits_;
+
+    std::unordered_map<Key, double, KeyHash> table_;
+    std::uint64_t nodes_ = 0;
+    bool aborted_ = false;
+
+    bool enumerate(const Board& board);
+
+    [[nodiscard]]
+    bool consistent(const Configuration& c, const Board& board) const noexcept;
+
+    [[nodiscard]]
+    double expected(const Subset& subset, std::uint64_t hash, const Bitboard& shot, std::size_t* bestCell);
+};
@@ -0,0 +1,403 @@
+﻿#include "FleetSampler.h"
+
+#include <algorithm>
+#include <bit>
+
+// ------------------------------------------------------------
+//  Константы раскладки
+//
+//  Профиль хранит по CellBits бит на столбец (см. FleetSampler.h),
+//  остаток флота — смешанная система счисления по длинам кораблей.
+// ------------------------------------------------------------
+namespace {
+
+    constexpr int Width = static_cast<int>(BOARD_SIZE);
+    constexpr int MaxLen = MAX_SHIP_LENGTH;
+
+    constexpr std::uint64_t Horizontal = MaxLen + 1;
+    constexpr int CellBits = std::bit_width(static_cast<unsigned>(Horizontal));
+    constexpr std::uint64_t CellMask = (std::uint64_t{ 1 } << CellBits) - 1;
+
+    static_assert(Width * CellBits <= 64, "Профиль строки не помещается в 64 бита");
+    static_assert(Width <= 16, "Строка не помещается в 16-битный шаблон");
+
+    // Сколько кораблей каждой длины во флоте
+    constexpr auto Multiplicity = [] {
+        std::array<int, MaxLen + 1> m{};
+        for (int len : SHIP_SIZES)
+            ++m[len];
+        return m;
+    }();
+
+    // Вес разряда каждой длины в остатке флота; CountBase[MaxLen + 1] — число остатков
+    constexpr auto CountBase = [] {
+        std::array<int, MaxLen + 2> base{};
+        base[1] = 1;
+        for (int len = 1; len <= MaxLen; ++len)
+            base[len + 1] = base[len] * (Multiplicity[len] + 1);
+        return base;
+    }();
+
+    constexpr int Remainders = CountBase[MaxLen + 1];
+    static_assert(Remainders <= 128, "Остаток флота не помещается в маску из 128 бит");
+
+    [[nodiscard]]
+    constexpr std::uint64_t cellOf(std::uint64_t profile, int x) noexcept {
+        return (profile >> (x * CellBits)) & CellMask;
+    }
+
+    // Добавляет к набору законченных кораблей корабль длины len
+    [[nodiscard]]
+    constexpr bool finishShip(int& finished, std::uint64_t len) noexcept {
+        if (len < 1 || len > static_cast<std::uint64_t>(MaxLen))
+            return false;
+
+        const int l = static_cast<int>(len);
+        if ((finished / CountBase[l]) % (Multiplicity[l] + 1) == Multiplicity[l])
+            return false;
+
+        finished += CountBase[l];
+        return true;
+    }
+
+} // namespace
+
+// ------------------------------------------------------------
+//  Общий экземпляр
+// ------------------------------------------------------------
+const FleetSampler& FleetSampler::instance() {
+    static const FleetSampler sampler;
+    return sampler;
+}
+
+// ------------------------------------------------------------
+//  Построение таблиц
+//
+//  1. Обход в ширину по профилям от пустого: для каждого профиля
+//     перебираются все заполнения следующей строки.
+//  2. Снизу вверх: G[r][p][d] — число способов заполнить строки
+//     r..BOARD_SIZE-1 из профиля p, израсходовав ровно остаток d.
+// ------------------------------------------------------------
+FleetSampler::FleetSampler() {
+    for (int len = 1; len <= MaxLen; ++len)
+        fullFleet_ += CountBase[len] * Multiplicity[len];
+
+    // Вычитание наборов кораблей по разрядам
+    minus_.assign(static_cast<std::size_t>(Remainders) * Remainders, -1);
+    for (int finished = 0; finished < Remainders; ++finished) {
+        for (int remaining = 0; remaining < Remainders; ++remaining) {
+            int rest = 0;
+            bool ok = true;
+            for (int len = 1; len <= MaxLen && ok; ++len) {
+                const int a = (remaining / CountBase[len]) % (Multiplicity[len] + 1);
+                const int b = (finished / CountBase[len]) % (Multiplicity[len] + 1);
+                ok = b <= a;
+                rest += (a - b) * CountBase[len];
+            }
+            if (ok)
+                minus_[static_cast<std::size_t>(finished) * Remainders + remaining] =
+                    static_cast<std::int16_t>(rest);
+        }
+    }
+
+    std::unordered_map<Profile, std::uint32_t> index;
+    index.emplace(0, 0);
+    profiles_.push_back(0);
+
+    for (std::size_t p = 0; p < profiles_.size(); ++p) {
+        firstTransition_.push_back(static_cast<std::uint32_t>(transitions_.size()));
+        expandRow(profiles_[p], index);
+    }
+    firstTransition_.push_back(static_cast<std::uint32_t>(transitions_.size()));
+
+    const std::size_t profileCount = profiles_.size();
+    std::vector<std::uint64_t> below(profileCount * Remainders, 0);
+    std::vector<std::uint64_t> current(profileCount * Remainders, 0);
+
+    // Последняя граница: незаконченные вертикальные корабли заканчиваются краем поля
+    for (std::size_t p = 0; p < profileCount; ++p) {
+        int finished = 0;
+        bool ok = true;
+        for (int x = 0; x < Width && ok; ++x) {
+            const std::uint64_t c = cellOf(profiles_[p], x);
+            if (c != 0 && c != Horizontal)
+                ok = finishShip(finished, c);
+        }
+        if (ok)
+            below[p * Remainders + static_cast<std::size_t>(finished)] = 1;
+    }
+
+    auto compress = [&](const std::vector<std::uint64_t>& dense) {
+        CountTable table;
+        table.present.resize(profileCount);
+        table.offset.resize(profileCount);
+
+        for (std::size_t p = 0; p < profileCount; ++p) {
+            table.offset[p] = static_cast<std::uint32_t>(table.values.size());
+            for (int d = 0; d < Remainders; ++d) {
+                const std::uint64_t v = dense[p * Remainders + static_cast<std::size_t>(d)];
+                if (v == 0)
+                    continue;
+                table.present[p][static_cast<std::size_t>(d / 64)] |= std::uint64_t{ 1 } << (d % 64);
+                table.values.push_back(v);
+            }
+        }
+        table.values.shrink_to_fit();
+        return table;
+    };
+
+    tables_.resize(BOARD_SIZE + 1);
+    tables_[BOARD_SIZE] = compress(below);
+
+    for (int r = Width - 1; r >= 0; --r) {
+        std::fill(current.begin(), current.end(), 0);
+
+        for (std::size_t p = 0; p < profileCount; ++p) {
+            std::uint64_t* out = &current[p * Remainders];
+
+            for (std::uint32_t t = firstTransition_[p]; t < firstTransition_[p + 1]; ++t) {
+                const Transition& tr = transitions_[t];
+                const std::int16_t* rest = &minus_[static_cast<std::size_t>(tr.finished) * Remainders];
+                const std::uint64_t* in = &below[static_cast<std::size_t>(tr.next) * Remainders];
+
+                for (int d = 0; d < Remainders; ++d)
+                    if (rest[d] >= 0)
+                        out[d] += in[rest[d]];
+            }
+        }
+
+        tables_[static_cast<std::size_t>(r)] = compress(current);
+        std::swap(below, current);
+    }
+
+    total_ = tables_[0].at(0, fullFleet_);
+}
+
+// ------------------------------------------------------------
+//  Все заполнения строки под профилем above
+//
+//  Перебор идёт слева направо, «вода» раньше «палубы», поэтому
+//  переходы профиля лежат в лексикографическом порядке строки.
+// ------------------------------------------------------------
+void FleetSampler::expandRow(
+    Profile above,
+    std::unordered_map<Profile, std::uint32_t>& index
+) {
+    auto indexOf = [&](Profile p) {
+        const auto [it, inserted] = index.emplace(p, static_cast<std::uint32_t>(profiles_.size()));
+        if (inserted)
+            profiles_.push_back(p);
+        return it->second;
+    };
+
+    // x — столбец, row — уже заполненная часть строки, run — длина
+    // горизонтального отрезка слева, upLeft — занята ли клетка (x-1, y-1)
+    auto fill = [&](auto&& self, int x, Profile row, int run, bool upLeft,
+                    int finished, std::uint16_t pattern) -> void {
+        if (x == Width) {
+            if (run >= 2 && !finishShip(finished, static_cast<std::uint64_t>(run)))
+                return;
+            transitions_.push_back({ indexOf(row), pattern, static_cast<std::uint16_t>(finished) });
+            return;
+        }
+
+        const std::uint64_t up = cellOf(above, x);
+        const std::uint64_t left = x > 0 ? cellOf(row, x - 1) : 0;
+        const bool upRight = x + 1 < Width && cellOf(above, x + 1) != 0;
+
+        // Вода: заканчиваются вертикальный корабль сверху и отрезок слева
+        {
+            int f = finished;
+            bool ok = true;
+            if (up != 0 && up != Horizontal)
+                ok = finishShip(f, up);
+            if (ok && run >= 2)
+                ok = finishShip(f, static_cast<std::uint64_t>(run));
+            if (ok)
+                self(self, x + 1, row, 0, up != 0, f, pattern);
+        }
+
+        // Палуба: диагональные соседи и горизонтальный корабль сверху запрещают её
+        if (upLeft || upRight || up == Horizontal)
+            return;
+
+        const auto bit = static_cast<std::uint16_t>(pattern | (1u << x));
+        const int shift = x * CellBits;
+
+        if (up != 0) {
+            // Продолжение вертикального корабля
+            if (left != 0 || up + 1 > static_cast<std::uint64_t>(MaxLen))
+                return;
+            self(self, x + 1, row | ((up + 1) << shift), 0, true, finished, bit);
+        }
+        else if (left != 0) {
+            // Продолжение горизонтального: левая палуба уже не растёт вниз
+            if (run == 0 || run + 1 > MaxLen)
+                return;
+            const int leftShift = shift - CellBits;
+            const Profile next = (row & ~(CellMask << leftShift))
+                | (Horizontal << leftShift) | (Horizontal << shift);
+            self(self, x + 1, next, run + 1, false, finished, bit);
+        }
+        else {
+            self(self, x + 1, row | (std::uint64_t{ 1 } << shift), 1, false, finished, bit);
+        }
+    };
+
+    fill(fill, 0, 0, 0, false, 0, 0);
+}
+
+// ------------------------------------------------------------
+//  Вспомогательные запросы к таблицам
+// ------------------------------------------------------------
+std::uint64_t FleetSampler::CountTable::at(std::uint32_t profile, int remaining) const noexcept {
+    const auto& mask = present[profile];
+    const std::size_t word = static_cast<std::size_t>(remaining / 64);
+    const std::uint64_t bit = std::uint64_t{ 1 } << (remaining % 64);
+
+    if (!(mask[word] & bit))
+        return 0;
+
+    std::size_t i = offset[profile] + static_cast<std::size_t>(std::popcount(mask[word] & (bit - 1)));
+    if (word == 1)
+        i += static_cast<std::size_t>(std::popcount(mask[0]));
+    return values[i];
+}
+
+int FleetSampler::subtract(int remaining, int finished) const noexcept {
+    return minus_[static_cast<std::size_t>(finished) * Remainders + static_cast<std::size_t>(remaining)];
+}
+
+// ------------------------------------------------------------
+//  Флот по номеру
+//
+//  По строкам: переходы текущего профиля перебираются по порядку,
+//  из id вычитается число флотов за каждым пропущенным переходом.
+// ------------------------------------------------------------
+Fleet FleetSampler::unrank(std::uint64_t id) const noexcept {
+    Bitboard ships;
+    std::uint32_t profile = 0;
+    int remaining = fullFleet_;
+
+    for (int y = 0; y < Width; ++y) {
+        const CountTable& below = tables_[static_cast<std::size_t>(y) + 1];
+
+        for (std::uint32_t t = firstTransition_[profile]; t < firstTransition_[profile + 1]; ++t) {
+            const Transition& tr = transitions_[t];
+            const int rest = subtract(remaining, tr.finished);
+            if (rest < 0)
+                continue;
+
+            const std::uint64_t n = below.at(tr.next, rest);
+            if (id >= n) {
+                id -= n;
+                continue;
+            }
+
+            for (int x = 0; x < Width; ++x)
+                if (tr.pattern & (1u << x))
+                    ships.set(Bitboard::indexOf(x, y));
+
+            profile = tr.next;
+            remaining = rest;
+            break;
+        }
+    }
+
+    return fleetFromMask(ships);
+}
+
+// ------------------------------------------------------------
+//  Номер флота по маске палуб
+// ------------------------------------------------------------
+std::optional<std::uint64_t> FleetSampler::rank(const Bitboard& ships) const noexcept {
+    std::uint64_t id = 0;
+    std::uint32_t profile = 0;
+    int remaining = fullFleet_;
+
+    for (int y = 0; y < Width; ++y) {
+        const CountTable& below = tables_[static_cast<std::size_t>(y) + 1];
+
+        std::uint16_t pattern = 0;
+        for (int x = 0; x < Width; ++x)
+            if (ships.test(Bitboard::indexOf(x, y)))
+                pattern = static_cast<std::uint16_t>(pattern | (1u << x));
+
+        bool found = false;
+        for (std::uint32_t t = firstTransition_[profile]; t < firstTransition_[profile + 1]; ++t) {
+            const Transition& tr = transitions_[t];
+            const int rest = subtract(remaining, tr.finished);
+
+            if (tr.pattern == pattern) {
+                if (rest < 0)
+                    return std::nullopt;
+                profile = tr.next;
+                remaining = rest;
+                found = true;
+                break;
+            }
+            if (rest >= 0)
+                id += below.at(tr.next, rest);
+        }
+
+        if (!found)
+            return std::nullopt;
+    }
+
+    if (tables_[BOARD_SIZE].at(profile, remaining) == 0)
+        return std::nullopt;
+    return id;
+}
+
+// ------------------------------------------------------------
+//  Равномерно случайный флот
+// ------------------------------------------------------------
+Fleet FleetSampler::sample(std::mt19937& rng) const {
+    std::uniform_int_distribution<std::uint64_t> dist(0, total_ - 1);
+    return unrank(dist(rng));
+}
+
+// ------------------------------------------------------------
+//  Разбор маски палуб на корабли в порядке SHIP_SIZES
+// ------------------------------------------------------------
+Fleet FleetSampler::fleetFromMask(const Bitboard& ships) noexcept {
+    std::array<Ship, SHIP_SIZES.size()> found{};
+    std::size_t count = 0;
+
+    Bitboard rest = ships;
+    while (rest.any() && count < found.size()) {
+        const std::size_t index = rest.lowest();
+        const int x = static_cast<int>(index % BOARD_SIZE);
+        const int y = static_cast<int>(index / BOARD_SIZE);
+
+        // Палуба справа — корабль горизонтальный, иначе растёт вниз
+        const bool horizontal = x + 1 < Width && rest.test(index + 1);
+        const std::size_t stepSize = horizontal ? 1 : BOARD_SIZE;
+
+        Ship ship{ x, y, 0, horizontal, {} };
+        for (std::size_t i = index; i < Bitboard::Cells && rest.test(i); i += stepSize) {
+            ship.body.set(i);
+            ++ship.length;
+            if (horizontal && (i + 1) % BOARD_SIZE == 0)
+                break;
+        }
+
+        rest &= ~ship.body;
+        found[count++] = ship;
+    }
+
+    // Раскладываем корабли по ячейкам SHIP_SIZES с той же длиной
+    Fleet fleet{};
+    std::array<bool, SHIP_SIZES.size()> used{};
+
+    for (std::size_t slot = 0; slot < SHIP_SIZES.size(); ++slot) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!used[i] && found[i].length == SHIP_SIZES[slot]) {
+                fleet[slot] = found[i];
+                used[i] = true;
+                break;
+            }
+        }
+    }
+    return fleet;
+}
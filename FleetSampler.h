@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "Bitboard.h"
+#include "GameConfig.h"
+#include "Ship.h"
+
+/**
+ * @class FleetSampler
+ * @brief Нумерация всех допустимых расстановок флота SHIP_SIZES.
+ *
+ * Считает расстановки, в которых корабли не касаются ни сторонами,
+ * ни углами (одинаковые корабли неразличимы), динамикой по строкам
+ * поля. Каждой расстановке соответствует номер в [0, count()),
+ * который служит компактным 64-битным ID флота:
+ *  - unrank(id) восстанавливает флот по номеру,
+ *  - rank(ships) даёт номер по маске палуб,
+ *  - sample(rng) — равномерно случайный флот.
+ *
+ * Номера идут в лексикографическом порядке клеток (по строкам,
+ * «вода» раньше «палубы»). Таблицы строятся один раз при первом
+ * вызове instance() (около 1,5 с и ~100 МБ), после чего все запросы
+ * только читают их и безопасны из нескольких потоков.
+ */
+class FleetSampler {
+public:
+    /**
+     * @brief Общий экземпляр для BOARD_SIZE и SHIP_SIZES.
+     */
+    [[nodiscard]]
+    static const FleetSampler& instance();
+
+    /**
+     * @brief Число допустимых расстановок флота.
+     */
+    [[nodiscard]]
+    std::uint64_t count() const noexcept { return total_; }
+
+    /**
+     * @brief Флот с номером id (id < count()).
+     */
+    [[nodiscard]]
+    Fleet unrank(std::uint64_t id) const noexcept;
+
+    /**
+     * @brief Номер флота по маске палуб.
+     *
+     * @return std::nullopt — маска не является допустимой расстановкой SHIP_SIZES.
+     */
+    [[nodiscard]]
+    std::optional<std::uint64_t> rank(const Bitboard& ships) const noexcept;
+
+    /**
+     * @brief Равномерно случайный флот.
+     */
+    [[nodiscard]]
+    Fleet sample(std::mt19937& rng) const;
+
+private:
+    FleetSampler();
+
+    /**
+     * Профиль — состояние клеток строки, уже пройденной динамикой,
+     * по CellBits бит на столбец:
+     *   0                    — вода;
+     *   1..MAX_SHIP_LENGTH   — палуба корабля, который может расти вниз
+     *                          (сколько палуб в столбце уже набрано);
+     *   MAX_SHIP_LENGTH + 1  — палуба горизонтального корабля.
+     *
+     * Остаток флота — число в смешанной системе счисления
+     * (разряд длины L от 0 до числа кораблей длины L в SHIP_SIZES).
+     */
+    using Profile = std::uint64_t;
+
+    // Вариант заполнения одной строки при заданном профиле над ней
+    struct Transition {
+        std::uint32_t next;       ///< индекс профиля после строки
+        std::uint16_t pattern;    ///< занятые клетки строки (бит x)
+        std::uint16_t finished;   ///< корабли, законченные в этой строке
+    };
+
+    // Число достроек флота от границы строк: по профилю и остатку флота.
+    // Хранятся только ненулевые значения: маска остатков + смещение.
+    struct CountTable {
+        std::vector<std::array<std::uint64_t, 2>> present;
+        std::vector<std::uint32_t> offset;
+        std::vector<std::uint64_t> values;
+
+        [[nodiscard]]
+        std::uint64_t at(std::uint32_t profile, int remaining) const noexcept;
+    };
+
+    std::vector<Profile> profiles_;
+    std::vector<std::uint32_t> firstTransition_;   ///< CSR: переходы профиля p — [first[p], first[p + 1])
+    std::vector<Transition> transitions_;
+    std::vector<CountTable> tables_;                ///< tables_[r] — перед строкой r (r = 0..BOARD_SIZE)
+    std::vector<std::int16_t> minus_;               ///< остаток минус законченные корабли (-1 — не хватает)
+    int fullFleet_ = 0;
+    std::uint64_t total_ = 0;
+
+    void expandRow(
+        Profile above,
+        std::unordered_map<Profile, std::uint32_t>& index
+    );
+
+    [[nodiscard]]
+    int subtract(int remaining, int finished) const noexcept;
+
+    [[nodiscard]]
+    static Fleet fleetFromMask(const Bitboard& ships) noexcept;
+};
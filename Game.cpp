@@ -1,5 +1,9 @@
 #include "Game.h"
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 Game::Game()
     : window_(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), L" ", sf::Style::Titlebar | sf::Style::Close),
     rng_(static_cast<unsigned>(std::time(nullptr))),
@@ -18,10 +22,42 @@ Game::Game()
     statusText_.setFont(font_);
     statusText_.setCharacterSize(24);
     statusText_.setFillColor(sf::Color::White);
+    statusText_.setPosition(200.f, WINDOW_HEIGHT - 100.f);
 
     // 
     cursorArrow_.loadFromSystem(sf::Cursor::Arrow);
     cursorCrosshair_.loadFromSystem(sf::Cursor::Cross);
+    window_.setMouseCursor(cursorArrow_);
+
+    // -----------------------------
+    // 
+    // -----------------------------
+    overlayText_.setFont(font_);
+    overlayText_.setCharacterSize(14);
+    overlayText_.setFillColor(Style::OverlayText);
+    overlayText_.setPosition(10.f, 10.f);
+
+    tracePath_ = Profiler::tracePathFromEnvironment();
+    if (!tracePath_.empty())
+        Profiler::setEnabled(true);
+
+    // -----------------------------
+    //  : ,     (   ),
+    //     
+    // -----------------------------
+    SearchConfig search;
+    search.seconds = turnTimeLimit_ - 0.5f;
+    search.nodes = 0;
+    search.threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    aiController_.enableSearch(search);
+
+    //      (battleship_book --search-ms 4500) 
+    //    ;      
+    //     
+    AiSettings bookSettings;
+    bookSettings.search = search;
+    if (openingBook_.open("opening.book", bookSettings))
+        aiController_.setOpeningBook(&openingBook_);
 
     // -----------------------------
     //  
@@ -39,39 +75,85 @@ Game::Game()
     // -----------------------------
     //  
     // -----------------------------
+    resetGame();
+}
+
+// ------------------------------------------------------------
+//  
+// ------------------------------------------------------------
+Game::~Game() {
+    if (!tracePath_.empty() && !Profiler::writeChromeTrace(tracePath_))
+        std::cerr << "     " << tracePath_ << '\n';
+}
+
+// ------------------------------------------------------------
+//  
+// ------------------------------------------------------------
+void Game::resetGame() {
+    //            ,
+    //  AIController     
+    aiWorker_.cancel();
+    aiController_.reset();
+
     playerBoard_.randomPlaceFleet(rng_);
     aiBoard_.randomPlaceFleet(rng_);
 
-    // -----------------------------
-    //    
-    // -----------------------------
-    for (int y = 0; y < BOARD_SIZE; ++y)
-        for (int x = 0; x < BOARD_SIZE; ++x)
-            aiShots_[y][x] = false;
+    //     
+    aiShots_ = {};
+
+    playerTurn_ = true;
+    gameOver_ = false;
+    playerWon_ = false;
+    turnClock_.restart();
 
+    dirty_ = true;
     updateStatusText();
 }
 
 // ------------------------------------------------------------
-//   
+//    ( ,    )
 // ------------------------------------------------------------
 void Game::updateStatusText() {
     float remaining = turnTimeLimit_ - turnClock_.getElapsedTime().asSeconds();
     if (remaining < 0) remaining = 0;
 
+    std::wstring status;
     if (gameOver_) {
-        statusText_.setString(playerWon_
-            ? L" !   ."
-            : L" !   .");
+        status = playerWon_
+            ? L" !   , R  ."
+            : L" !   , R  .";
     }
     else {
         if (playerTurn_)
-            statusText_.setString(L" ");
+            status = L" ";
+        else if (remaining > 0 || !aiWorker_.busy())
+            status = L"  (" + std::to_wstring((int)remaining) + L" )";
         else
-            statusText_.setString(L"  (" + std::to_wstring((int)remaining) + L" )");
+            status = L"  (...)";
     }
 
-    statusText_.setPosition(200.f, WINDOW_HEIGHT - 100.f);
+    if (status != status_) {
+        status_ = std::move(status);
+        statusText_.setString(status_);
+        dirty_ = true;
+    }
+}
+
+// ------------------------------------------------------------
+// :        (   )
+// ------------------------------------------------------------
+void Game::updateCursor() {
+    int boardPixelSize = BOARD_SIZE * CELL_SIZE;
+
+    const bool crosshair =
+        mouse_.x >= aiBoardX_ && mouse_.x < aiBoardX_ + boardPixelSize &&
+        mouse_.y >= boardsY_ && mouse_.y < boardsY_ + boardPixelSize &&
+        playerTurn_ && !gameOver_;
+
+    if (crosshair != crosshair_) {
+        crosshair_ = crosshair;
+        window_.setMouseCursor(crosshair ? cursorCrosshair_ : cursorArrow_);
+    }
 }
 
 // ------------------------------------------------------------
@@ -79,6 +161,7 @@ void Game::updateStatusText() {
 // ------------------------------------------------------------
 void Game::handlePlayerClick(int mouseX, int mouseY) {
     if (gameOver_) {
+        aiWorker_.cancel();
         window_.close();
         return;
     }
@@ -123,26 +206,165 @@ void Game::handlePlayerClick(int mouseX, int mouseY) {
             break;
         }
 
+        dirty_ = true;
         updateStatusText();
     }
 }
 
 // ------------------------------------------------------------
-//   SFML
+//  
+//
+//      ,    waitEvent. 
+//    :  SFML 2.6  waitEvent  ,
+//   pollEvent   sf::sleep.   
+//  .
 // ------------------------------------------------------------
-void Game::handleEvents() {
+void Game::waitForEvents() {
+    //  :        
+    const sf::Time pollStep = sf::milliseconds(10);
+
     sf::Event event{};
-    while (window_.pollEvent(event)) {
-        if (event.type == sf::Event::Closed)
-            window_.close();
-
-        if (event.type == sf::Event::MouseButtonPressed &&
-            event.mouseButton.button == sf::Mouse::Left)
-        {
-            sf::Vector2i mousePos = sf::Mouse::getPosition(window_);
-            handlePlayerClick(mousePos.x, mousePos.y);
+    if (!dirty_) {
+        const sf::Time timeout = timeToNextChange();
+
+        if (timeout == sf::Time::Zero) {
+            if (window_.waitEvent(event))
+                handleEvent(event);
+        }
+        else {
+            sf::Clock waited;
+            while (window_.isOpen() && !window_.pollEvent(event)) {
+                const sf::Time left = timeout - waited.getElapsedTime();
+                if (left <= sf::Time::Zero)
+                    return;
+                sf::sleep(std::min(left, pollStep));
+            }
+            handleEvent(event);
         }
     }
+
+    while (window_.isOpen() && window_.pollEvent(event))
+        handleEvent(event);
+}
+
+// ------------------------------------------------------------
+//      
+//
+// Zero    (    ):  .
+//          ,   
+//     AIWorker.
+// ------------------------------------------------------------
+sf::Time Game::timeToNextChange() const {
+    //         
+    sf::Time overlay = sf::Time::Zero;
+    if (overlay_)
+        overlay = std::max(OverlayPeriod - overlayClock_.getElapsedTime(), sf::milliseconds(1));
+
+    if (gameOver_ || playerTurn_)
+        return overlay;
+
+    sf::Time timer = sf::milliseconds(5);
+    const float remaining = turnTimeLimit_ - turnClock_.getElapsedTime().asSeconds();
+    if (remaining > 0) {
+        //     (   )
+        timer = sf::seconds(remaining - std::floor(remaining)) + sf::milliseconds(1);
+    }
+    return overlay_ ? std::min(timer, overlay) : timer;
+}
+
+// ------------------------------------------------------------
+//   
+// ------------------------------------------------------------
+void Game::toggleOverlay() {
+    overlay_ = !overlay_;
+
+    //       
+    if (overlay_ && !Profiler::enabled())
+        Profiler::setEnabled(true);
+    else if (!overlay_ && tracePath_.empty())
+        Profiler::setEnabled(false);
+
+    updateOverlay(true);
+}
+
+void Game::updateOverlay(bool force) {
+    if (!overlay_ || (!force && overlayClock_.getElapsedTime() < OverlayPeriod))
+        return;
+
+    overlayClock_.restart();
+    const std::string summary = Profiler::summary();
+    overlayText_.setString(sf::String::fromUtf8(summary.begin(), summary.end()));
+    dirty_ = true;
+}
+
+// ------------------------------------------------------------
+//   SFML
+// ------------------------------------------------------------
+void Game::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::Closed) {
+        aiWorker_.cancel();
+        window_.close();
+    }
+
+    if (event.type == sf::Event::KeyPressed &&
+        event.key.code == sf::Keyboard::R)
+    {
+        resetGame();
+    }
+
+    if (event.type == sf::Event::KeyPressed &&
+        event.key.code == sf::Keyboard::F3)
+    {
+        toggleOverlay();
+    }
+
+    if (event.type == sf::Event::MouseMoved)
+        mouse_ = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+
+    if (event.type == sf::Event::MouseLeft)
+        mouse_ = sf::Vector2i(-1, -1);
+
+    if (event.type == sf::Event::MouseButtonPressed &&
+        event.mouseButton.button == sf::Mouse::Left)
+    {
+        mouse_ = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+        handlePlayerClick(event.mouseButton.x, event.mouseButton.y);
+    }
+
+    //    
+    if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus)
+        dirty_ = true;
+}
+
+// ------------------------------------------------------------
+//  
+//
+//     AIWorker      ,
+//       .  ,
+//      ;       ,
+//  .
+// ------------------------------------------------------------
+void Game::updateAiTurn() {
+    if (gameOver_ || playerTurn_)
+        return;
+
+    if (!aiWorker_.busy())
+        aiWorker_.request(playerBoard_, aiShots_);
+
+    float remaining = turnTimeLimit_ - turnClock_.getElapsedTime().asSeconds();
+
+    if (remaining <= 0) {
+        if (auto target = aiWorker_.poll()) {
+            bool ended = aiController_.applyShot(*target, playerBoard_, aiShots_, playerTurn_, playerWon_);
+            if (ended) {
+                gameOver_ = true;
+            }
+            turnClock_.restart();
+            dirty_ = true;
+        }
+    }
+
+    updateStatusText();
 }
 
 // ------------------------------------------------------------
@@ -150,51 +372,44 @@ void Game::handleEvents() {
 // ------------------------------------------------------------
 void Game::run() {
     while (window_.isOpen()) {
-        handleEvents();
+        waitForEvents();
+        if (!window_.isOpen())
+            break;
+
+        //       
+        const std::uint64_t frameStart = Profiler::enabled() ? Profiler::now() : 0;
 
         // -----------------------------
         //    
         // -----------------------------
-        if (!gameOver_ && !playerTurn_) {
-            float remaining = turnTimeLimit_ - turnClock_.getElapsedTime().asSeconds();
-
-            if (remaining <= 0) {
-                bool ended = aiController_.takeTurn(playerBoard_, aiShots_, playerTurn_, playerWon_);
-                if (ended) {
-                    gameOver_ = true;
-                }
-                turnClock_.restart();
-            }
-
-            updateStatusText();
-        }
+        updateAiTurn();
 
         // -----------------------------
         // 
         // -----------------------------
-        sf::Vector2i mp = sf::Mouse::getPosition(window_);
-        int boardPixelSize = BOARD_SIZE * CELL_SIZE;
-
-        if (mp.x >= aiBoardX_ && mp.x < aiBoardX_ + boardPixelSize &&
-            mp.y >= boardsY_ && mp.y < boardsY_ + boardPixelSize &&
-            playerTurn_ && !gameOver_)
-        {
-            window_.setMouseCursor(cursorCrosshair_);
-        }
-        else {
-            window_.setMouseCursor(cursorArrow_);
-        }
+        updateCursor();
+        updateOverlay();
 
         // -----------------------------
-        // 
+        //      
         // -----------------------------
+        if (!dirty_)
+            continue;
+
         renderer_.draw(
             playerBoard_,
             aiBoard_,
             statusText_,
             playerBoardX_,
             aiBoardX_,
-            boardsY_
+            boardsY_,
+            overlay_ ? &overlayText_ : nullptr
         );
+        dirty_ = false;
+
+        if (Profiler::enabled()) {
+            Profiler::record(ProfileZone::Frame, frameStart, Profiler::now() - frameStart);
+            Profiler::count(ProfileCounter::Frames);
+        }
     }
 }
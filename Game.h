@@ -5,9 +5,13 @@
 #include <array>
 #include <iostream>
 #include <ctime>        //  std::time
+#include <string>
 
 #include "Board.h"
 #include "AIController.h"
+#include "AIWorker.h"
+#include "OpeningBook.h"
+#include "Profiler.h"
 #include "Renderer.h"
 #include "GameConfig.h"
 
@@ -16,10 +20,20 @@
  *
  *    :
  * ,  ,   .
+ *
+ *     -  (, , ).
+ *       ( ,  ), 
+ *    ;        
+ * (  ,  AIWorker).
+ *
+ * F3     (Profiler)  . 
+ *  BATTLESHIP_PROFILE=     
+ *     Chrome   .
  */
 class Game {
 public:
     Game();
+    ~Game();
     void run();
 
 private:
@@ -34,9 +48,17 @@ private:
     std::mt19937 rng_;
     Board playerBoard_;
     Board aiBoard_;
+
+    //   (  aiController_,    )
+    OpeningBook openingBook_;
+
     AIController aiController_;
     Renderer renderer_;
 
+    //  ,    (  aiController_,
+    //    )
+    AIWorker aiWorker_{ aiController_ };
+
     //      
     std::array<std::array<bool, BOARD_SIZE>, BOARD_SIZE> aiShots_{};
 
@@ -54,12 +76,35 @@ private:
     sf::Clock turnClock_;
     float turnTimeLimit_ = 5.0f;
 
+    //   
+    bool dirty_ = true;                      ///<    
+    std::wstring status_;                    ///<   statusText_
+
+    //   
+    sf::Text overlayText_;
+    bool overlay_ = false;                   ///<   
+    sf::Clock overlayClock_;                 ///<    overlayText_
+    static inline const sf::Time OverlayPeriod = sf::milliseconds(500);
+    std::string tracePath_;                  ///<     
+
     //  
-    void handleEvents();
+    void waitForEvents();
+    void handleEvent(const sf::Event& event);
     void handlePlayerClick(int mouseX, int mouseY);
+    void updateAiTurn();
     void updateStatusText();
+    void updateCursor();
+    void updateOverlay(bool force = false);
+    void toggleOverlay();
+    void resetGame();
+
+    //        
+    [[nodiscard]]
+    sf::Time timeToNextChange() const;
 
     //  
     sf::Cursor cursorArrow_;
     sf::Cursor cursorCrosshair_;
+    bool crosshair_ = false;                 ///<   
+    sf::Vector2i mouse_{ -1, -1 };           ///<     (-1   )
 };
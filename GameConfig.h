@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <array>
+#include <algorithm>
 
 /**
  * @file GameConfig.h
@@ -28,3 +29,16 @@ inline constexpr std::array<int, 10> SHIP_SIZES{
     2, 2, 2,    // 
     1, 1, 1, 1  // 
 };
+
+//    
+inline constexpr int MAX_SHIP_LENGTH = std::ranges::max(SHIP_SIZES);
+
+//    : SHIP_COUNTS[len]
+using ShipCounts = std::array<int, MAX_SHIP_LENGTH + 1>;
+
+inline constexpr ShipCounts SHIP_COUNTS = [] {
+    ShipCounts counts{};
+    for (int len : SHIP_SIZES)
+        ++counts[len];
+    return counts;
+}();
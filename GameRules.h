@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+#include "Bitboard.h"
+#include "GameConfig.h"
+
+/**
+ * @file GameRules.h
+ * @brief Правила партии (размер поля и флот) как параметр шаблонов ядра.
+ *
+ * BasicBoard, BasicProbabilityMap, BasicAIController и всё, что они
+ * используют, параметризованы типом правил: размер поля и длины
+ * кораблей — константы времени компиляции, поэтому маски, таблицы
+ * положений и циклы по полю у каждого варианта свои, без проверок
+ * размера во время игры. Варианты из RULES_VARIANTS собраны заранее
+ * (явные инстанцирования в .cpp); withRules() выбирает вариант
+ * по имени во время работы.
+ *
+ * Только у ClassicRules есть векторное ядро карты (ProbabilityKernel)
+ * и способы выбора хода по выборкам расстановок (MonteCarloMap,
+ * LookaheadSearch, EndgameSolver), кэш выбора и дебютная книга.
+ */
+template <std::size_t Size, auto Fleet>
+struct GameRules {
+    static constexpr std::size_t BoardSize = Size;
+    static constexpr std::size_t Cells = Size * Size;
+
+    // Длины кораблей, по убыванию
+    static constexpr auto ShipSizes = Fleet;
+
+    static constexpr int MaxShipLength = std::ranges::max(Fleet);
+
+    using Bitboard = BasicBitboard<Size, Size>;
+
+    // Число кораблей каждой длины: ShipCounts[len]
+    using Counts = std::array<int, MaxShipLength + 1>;
+
+    static constexpr Counts ShipCounts = [] {
+        Counts counts{};
+        for (int len : Fleet)
+            ++counts[len];
+        return counts;
+    }();
+
+    static_assert(std::ranges::is_sorted(Fleet, std::greater<>{}), "флот — по убыванию длин");
+    static_assert(std::ranges::min(Fleet) >= 1 && static_cast<std::size_t>(MaxShipLength) <= Size);
+    static_assert(Fleet.size() <= 127, "номер корабля хранится в std::int8_t");
+
+    // Флот заведомо помещается: корабли укладываются по строкам через одну,
+    // слева направо с промежутком в клетку, каждый — в первую строку, где
+    // есть место. Раз расстановка существует, randomPlaceFleet() с откатом
+    // её всегда найдёт.
+    static constexpr bool FleetFits = [] {
+        std::array<std::size_t, (Size + 1) / 2> used{};
+        for (int len : Fleet) {
+            const auto length = static_cast<std::size_t>(len);
+            auto row = std::ranges::find_if(used, [&](std::size_t u) {
+                return (u ? u + 1 + length : length) <= Size;
+                });
+            if (row == used.end())
+                return false;
+            *row = *row ? *row + 1 + length : length;
+        }
+        return true;
+    }();
+    static_assert(FleetFits, "флот не помещается на поле");
+};
+
+// Классический морской бой: поле и флот из GameConfig.h
+using ClassicRules = GameRules<BOARD_SIZE, SHIP_SIZES>;
+
+// Поле 10x10 с пятью кораблями 5-4-3-3-2
+inline constexpr std::array<int, 5> FIVE_SHIP_SIZES{ 5, 4, 3, 3, 2 };
+using FiveShipRules = GameRules<10, FIVE_SHIP_SIZES>;
+
+// Поле 12x12
+inline constexpr std::array<int, 11> LARGE_12_SHIP_SIZES{ 5, 4, 3, 3, 2, 2, 2, 1, 1, 1, 1 };
+using Large12Rules = GameRules<12, LARGE_12_SHIP_SIZES>;
+
+// Поле 15x15
+inline constexpr std::array<int, 15> LARGE_15_SHIP_SIZES{ 5, 4, 4, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 1 };
+using Large15Rules = GameRules<15, LARGE_15_SHIP_SIZES>;
+
+// Варианты, собранные заранее: X(тип правил, имя для withRules)
+#define RULES_VARIANTS(X)              \
+    X(ClassicRules, "classic")         \
+    X(FiveShipRules, "five-ship")      \
+    X(Large12Rules, "12x12")           \
+    X(Large15Rules, "15x15")
+
+// Наибольшее поле среди вариантов
+inline constexpr std::size_t MAX_RULES_CELLS = std::max({
+#define RULES_CELLS(Rules, name) Rules::Cells,
+    RULES_VARIANTS(RULES_CELLS)
+#undef RULES_CELLS
+});
+
+template <class Rules>
+inline constexpr bool IsClassicRules = std::is_same_v<Rules, ClassicRules>;
+
+// Тип правил, переданный в функцию-посетитель withRules()
+template <class Rules>
+struct RulesTag {
+    using type = Rules;
+};
+
+/**
+ * @brief Вызывает f(RulesTag<Rules>{}) для варианта с именем name.
+ *
+ * @return false — такого варианта нет (f не вызывается)
+ */
+template <class F>
+bool withRules(std::string_view name, F&& f) {
+#define RULES_DISPATCH(Rules, rulesName) \
+    if (name == rulesName) {             \
+        f(RulesTag<Rules>{});            \
+        return true;                     \
+    }
+    RULES_VARIANTS(RULES_DISPATCH)
+#undef RULES_DISPATCH
+    return false;
+}
+
+// Имена всех вариантов (для подсказки в утилитах)
+inline constexpr std::array RULES_NAMES{
+#define RULES_NAME(Rules, name) std::string_view{ name },
+    RULES_VARIANTS(RULES_NAME)
+#undef RULES_NAME
+};
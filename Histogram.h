@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LogHistogram
+ * @brief Гистограмма неотрицательных величин (например, наносекунд)
+ *        с логарифмическими корзинами.
+ *
+ * Значения меньше 2^SubBits хранятся точно, остальные — с
+ * относительной погрешностью не больше 2^-SubBits. Фиксированный
+ * размер без выделения памяти: гистограммы можно держать по одной
+ * на поток и сливать через merge().
+ */
+class LogHistogram {
+public:
+    static constexpr int SubBits = 4;
+
+    void add(std::uint64_t value) noexcept {
+        ++counts_[bucketOf(value)];
+        ++count_;
+        sum_ += value;
+        if (value > max_)
+            max_ = value;
+        if (value < min_)
+            min_ = value;
+    }
+
+    void merge(const LogHistogram& other) noexcept {
+        for (std::size_t i = 0; i < Buckets; ++i)
+            counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        if (other.max_ > max_)
+            max_ = other.max_;
+        if (other.min_ < min_)
+            min_ = other.min_;
+    }
+
+    [[nodiscard]]
+    std::uint64_t count() const noexcept { return count_; }
+
+    [[nodiscard]]
+    std::uint64_t max() const noexcept { return max_; }
+
+    [[nodiscard]]
+    std::uint64_t min() const noexcept { return count_ ? min_ : 0; }
+
+    [[nodiscard]]
+    double mean() const noexcept { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    /**
+     * @brief Квантиль: значение, не больше которого доля q всех значений (q в [0, 1]).
+     *
+     * Возвращает верхнюю границу корзины, но не больше max().
+     */
+    [[nodiscard]]
+    std::uint64_t percentile(double q) const noexcept {
+        if (count_ == 0)
+            return 0;
+
+        auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count_));
+        if (rank >= count_)
+            rank = count_ - 1;
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < Buckets; ++i) {
+            seen += counts_[i];
+            if (seen > rank) {
+                const std::uint64_t upper = upperBound(i);
+                return upper < max_ ? upper : max_;
+            }
+        }
+        return max_;
+    }
+
+private:
+    static constexpr std::size_t Buckets = static_cast<std::size_t>(64 - SubBits + 1) << SubBits;
+
+    std::array<std::uint64_t, Buckets> counts_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint64_t max_ = 0;
+    std::uint64_t min_ = ~std::uint64_t{ 0 };
+
+    // Группа — позиция старшего бита, внутри группы — SubBits следующих бит
+    [[nodiscard]]
+    static constexpr std::size_t bucketOf(std::uint64_t value) noexcept {
+        if (value < (std::uint64_t{ 1 } << SubBits))
+            return static_cast<std::size_t>(value);
+
+        const int top = std::bit_width(value) - 1;
+        const int shift = top - SubBits;
+        const auto mantissa = static_cast<std::size_t>((value >> shift) & ((1u << SubBits) - 1));
+        return (static_cast<std::size_t>(shift + 1) << SubBits) + mantissa;
+    }
+
+    [[nodiscard]]
+    static constexpr std::uint64_t upperBound(std::size_t bucket) noexcept {
+        if (bucket < (std::size_t{ 1 } << SubBits))
+            return bucket;
+
+        const int shift = static_cast<int>(bucket >> SubBits) - 1;
+        const std::uint64_t mantissa = bucket & ((std::size_t{ 1 } << SubBits) - 1);
+        const std::uint64_t lower = ((std::uint64_t{ 1 } << SubBits) + mantissa) << shift;
+        return lower + ((std::uint64_t{ 1 } << shift) - 1);
+    }
+};
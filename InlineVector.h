@@ -0,0 +1,77 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+/**
+ * @class InlineVector
+ * @brief Вектор фиксированной ёмкости без выделения памяти.
+ *
+ * Элементы лежат внутри объекта (std::array), поэтому добавление и
+ * удаление никогда не обращаются к куче. Ёмкость выбирается так,
+ * чтобы её заведомо хватало; добавление в заполненный вектор
+ * игнорируется.
+ */
+template <class T, std::size_t Capacity>
+class InlineVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    [[nodiscard]]
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    [[nodiscard]]
+    constexpr std::size_t size() const noexcept { return size_; }
+
+    [[nodiscard]]
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]]
+    constexpr bool full() const noexcept { return size_ == Capacity; }
+
+    constexpr void clear() noexcept { size_ = 0; }
+
+    constexpr void push_back(const T& value) noexcept {
+        if (size_ < Capacity)
+            items_[size_++] = value;
+    }
+
+    template <class... Args>
+    constexpr void emplace_back(Args&&... args) noexcept {
+        if (size_ < Capacity)
+            items_[size_++] = T(static_cast<Args&&>(args)...);
+    }
+
+    constexpr void pop_back() noexcept { --size_; }
+
+    [[nodiscard]] constexpr T& operator[](std::size_t i) noexcept { return items_[i]; }
+    [[nodiscard]] constexpr const T& operator[](std::size_t i) const noexcept { return items_[i]; }
+
+    [[nodiscard]] constexpr T& front() noexcept { return items_[0]; }
+    [[nodiscard]] constexpr const T& front() const noexcept { return items_[0]; }
+    [[nodiscard]] constexpr T& back() noexcept { return items_[size_ - 1]; }
+    [[nodiscard]] constexpr const T& back() const noexcept { return items_[size_ - 1]; }
+
+    [[nodiscard]] constexpr iterator begin() noexcept { return items_.data(); }
+    [[nodiscard]] constexpr iterator end() noexcept { return items_.data() + size_; }
+    [[nodiscard]] constexpr const_iterator begin() const noexcept { return items_.data(); }
+    [[nodiscard]] constexpr const_iterator end() const noexcept { return items_.data() + size_; }
+
+    /**
+     * @brief Удаляет элементы, для которых pred истинно (аналог std::erase_if).
+     */
+    template <class Pred>
+    friend constexpr std::size_t erase_if(InlineVector& v, Pred pred) {
+        const auto last = std::remove_if(v.begin(), v.end(), pred);
+        const auto removed = static_cast<std::size_t>(v.end() - last);
+        v.size_ -= removed;
+        return removed;
+    }
+
+private:
+    std::array<T, Capacity> items_{};
+    std::size_t size_ = 0;
+};
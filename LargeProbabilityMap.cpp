@@ -0,0 +1,174 @@
+﻿#include "LargeProbabilityMap.h"
+
+#include <algorithm>
+
+// ------------------------------------------------------------
+//  Конструктор
+// ------------------------------------------------------------
+LargeProbabilityMap::LargeProbabilityMap(std::size_t width, std::size_t height, unsigned threads)
+    : width_(width)
+    , height_(height)
+    , map_(width * height)
+    , columnBefore_(width)
+{
+    // На малом поле раздача по потокам дороже самого пересчёта
+    if (threads != 1 && width_ * height_ >= ParallelCells)
+        pool_ = std::make_unique<ThreadPool>(threads);
+    rowAfter_.resize((pool_ ? pool_->size() : 1) * width_);
+
+    // По несколько полос на поток, чтобы потоки кончали вместе;
+    // полоса столбцов не уже строки кэша
+    const std::size_t bands = pool_ ? std::size_t{ pool_->size() } * 4 : 1;
+    columnChunk_ = std::max<std::size_t>((width_ + bands - 1) / bands, 16);
+    rowChunk_ = std::max<std::size_t>((height_ + bands - 1) / bands, 1);
+    bandBest_.resize((height_ + rowChunk_ - 1) / rowChunk_);
+}
+
+LargeProbabilityMap::~LargeProbabilityMap() = default;
+
+// ------------------------------------------------------------
+//  Полосы: по пулу или в вызывающем потоке
+// ------------------------------------------------------------
+template <class F>
+void LargeProbabilityMap::forBands(std::size_t count, std::size_t chunk, F&& body) const
+{
+    if (pool_)
+        pool_->parallelFor(count, chunk, body);
+    else
+        for (std::size_t begin = 0; begin < count; begin += chunk)
+            body(begin, std::min(count, begin + chunk), 0u);
+}
+
+// ------------------------------------------------------------
+//  Профиль покрытия
+//
+// Корабль длины L накрывает клетку, если начинается за t = 0..L-1
+// клеток до неё, не раньше начала отрезка (t < before) и не позже,
+// чем за L клеток до его конца (t >= L - after). Здесь before и after
+// — свободные клетки от начала и до конца отрезка, считая саму клетку.
+// Это разность префиксных сумм начал:
+// min(L, before) - max(0, L - after), и before и after больше Lmax
+// на неё не влияют. Поэтому покрытие всеми длинами — таблица
+// profile_[before * stride_ + after] по счётчикам, насыщенным на
+// Lmax; 0 — закрытая клетка (покрытие 0).
+// ------------------------------------------------------------
+void LargeProbabilityMap::buildProfile(std::span<const int> weights)
+{
+    int maxLength = 1;
+    for (std::size_t len = 1; len < weights.size(); ++len)
+        if (weights[len] > 0)
+            maxLength = static_cast<int>(len);
+
+    top_ = maxLength;
+    stride_ = static_cast<std::size_t>(maxLength) + 1;
+    profile_.assign(stride_ * stride_, 0);
+
+    for (int before = 1; before <= top_; ++before) {
+        for (int after = 1; after <= top_; ++after) {
+            int& cell = profile_[static_cast<std::size_t>(before) * stride_ + static_cast<std::size_t>(after)];
+            for (int len = 1; len <= maxLength && static_cast<std::size_t>(len) < weights.size(); ++len) {
+                const int starts = std::min(len, before) - std::max(0, len - after);
+                if (starts > 0)
+                    cell += weights[static_cast<std::size_t>(len)] * starts;
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+//  Пересчёт карты
+//
+// Счётчики копятся без ветвлений — min(счётчик + 1, Lmax), обнулённый
+// маской на закрытой клетке: при случайных промахах ветка на каждой
+// клетке предсказывалась бы плохо. before — в прямом проходе,
+// after — в обратном.
+// ------------------------------------------------------------
+void LargeProbabilityMap::compute(std::span<const std::uint8_t> blocked, std::span<const int> weights)
+{
+    buildProfile(weights);
+
+    const std::size_t w = width_;
+    const std::size_t h = height_;
+    const int top = top_;
+    const std::size_t stride = stride_;
+    const int* profile = profile_.data();
+    int* map = map_.data();
+
+    // Столбцы: снизу вверх — after (временно в map_), сверху вниз —
+    // before по столбцу в columnBefore_ и покрытие. Внутренние циклы
+    // идут по столбцам полосы и не зависят друг от друга
+    forBands(w, columnChunk_, [&](std::size_t begin, std::size_t end, unsigned) {
+        int* before = columnBefore_.data();
+
+        for (std::size_t y = h; y-- > 0;) {
+            const std::size_t row = y * w;
+            for (std::size_t x = begin; x < end; ++x) {
+                const int below = y + 1 < h ? map[row + w + x] : 0;
+                map[row + x] = std::min(below + 1, top) & -static_cast<int>(blocked[row + x] == 0);
+            }
+        }
+
+        for (std::size_t x = begin; x < end; ++x)
+            before[x] = 0;
+        for (std::size_t y = 0; y < h; ++y) {
+            const std::size_t row = y * w;
+            for (std::size_t x = begin; x < end; ++x) {
+                const int after = map[row + x];
+                before[x] = std::min(before[x] + 1, top) & -static_cast<int>(after != 0);
+                map[row + x] = profile[static_cast<std::size_t>(before[x]) * stride + static_cast<std::size_t>(after)];
+            }
+        }
+        });
+
+    // Строки: справа налево — after во временную строку потока,
+    // слева направо — before и покрытие
+    forBands(h, rowChunk_, [&](std::size_t begin, std::size_t end, unsigned worker) {
+        int* afters = rowAfter_.data() + std::size_t{ worker } * w;
+
+        for (std::size_t y = begin; y < end; ++y) {
+            const std::uint8_t* closed = blocked.data() + y * w;
+            int* out = map + y * w;
+
+            int after = 0;
+            for (std::size_t x = w; x-- > 0;) {
+                after = std::min(after + 1, top) & -static_cast<int>(closed[x] == 0);
+                afters[x] = after;
+            }
+
+            int before = 0;
+            for (std::size_t x = 0; x < w; ++x) {
+                before = std::min(before + 1, top) & -static_cast<int>(closed[x] == 0);
+                out[x] += profile[static_cast<std::size_t>(before) * stride + static_cast<std::size_t>(afters[x])];
+            }
+        }
+        });
+}
+
+// ------------------------------------------------------------
+//  Лучшая клетка
+// ------------------------------------------------------------
+std::size_t LargeProbabilityMap::best(std::span<const std::uint8_t> skip) const
+{
+    const std::size_t none = cells();
+
+    forBands(height_, rowChunk_, [&](std::size_t begin, std::size_t end, unsigned) {
+        // Пропущенная клетка получает -1 без ветвления; улучшения
+        // редки, поэтому ветка на них предсказывается
+        BandBest band{ -1, none };
+        for (std::size_t index = begin * width_; index < end * width_; ++index) {
+            const int score = map_[index] | -static_cast<int>(skip[index] != 0);
+            if (score > band.score) {
+                band.score = score;
+                band.index = index;
+            }
+        }
+        bandBest_[begin / rowChunk_] = band;
+        });
+
+    // Полосы сливаются по порядку: при равенстве побеждает первая клетка
+    BandBest result{ -1, none };
+    for (const BandBest& band : bandBest_)
+        if (band.index != none && band.score > result.score)
+            result = band;
+    return result.index;
+}
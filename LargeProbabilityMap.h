@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/**
+ * @class LargeProbabilityMap
+ * @brief Карта покрытия для больших полей (100x100 и больше) —
+ *        стресс-прогоны и варианты правил.
+ *
+ * ProbabilityMap перебирает положения кораблей по таблице, построенной
+ * при компиляции; для большого поля ни таблица, ни перебор положений
+ * (каждое — проверка L клеток) не годятся. Здесь для каждой свободной
+ * клетки двумя проходами по строке (и по столбцу) находится, сколько
+ * свободных клеток до начала и до конца её отрезка. Число положений
+ * корабля длины L через клетку — разность префиксных сумм начал
+ * отрезка и зависит только от этих двух чисел, обрезанных до Lmax - 1;
+ * веса всех длин сводятся в одну маленькую таблицу за пересчёт,
+ * поэтому пересчёт — O(N²) при любом флоте, без ветвлений по клеткам.
+ *
+ * Однопалубный считается и горизонтальным, и вертикальным — как
+ * в ProbabilityMap. Столбцы обходятся полосами столбцов, строки —
+ * полосами строк; полосы раздаются по пулу потоков.
+ */
+class LargeProbabilityMap {
+public:
+    // Меньшее поле считается в вызывающем потоке
+    static constexpr std::size_t ParallelCells = std::size_t{ 1 } << 14;
+
+    /**
+     * @param threads  потоки (0 — по числу ядер, 1 — в вызывающем потоке);
+     *                 поле меньше ParallelCells клеток — всегда в вызывающем
+     */
+    LargeProbabilityMap(std::size_t width, std::size_t height, unsigned threads = 1);
+    ~LargeProbabilityMap();
+
+    LargeProbabilityMap(const LargeProbabilityMap&) = delete;
+    LargeProbabilityMap& operator=(const LargeProbabilityMap&) = delete;
+
+    /**
+     * @brief Пересчитывает карту.
+     *
+     * @param blocked  width * height клеток по строкам; не 0 — корабля
+     *                 в клетке нет (промах, затопленный, вывод)
+     * @param weights  weights[len] — кораблей длины len (weights[0] не используется)
+     */
+    void compute(std::span<const std::uint8_t> blocked, std::span<const int> weights);
+
+    /**
+     * @brief Клетка с наибольшим покрытием среди тех, где skip == 0
+     *        (при равенстве — первая по строкам; cells() — таких нет).
+     */
+    [[nodiscard]]
+    std::size_t best(std::span<const std::uint8_t> skip) const;
+
+    // Покрытие клеток по строкам
+    [[nodiscard]]
+    std::span<const int> map() const noexcept { return map_; }
+
+    [[nodiscard]]
+    int at(std::size_t x, std::size_t y) const noexcept { return map_[y * width_ + x]; }
+
+    [[nodiscard]]
+    std::size_t width() const noexcept { return width_; }
+
+    [[nodiscard]]
+    std::size_t height() const noexcept { return height_; }
+
+    [[nodiscard]]
+    std::size_t cells() const noexcept { return map_.size(); }
+
+private:
+    // Лучшая клетка полосы строк (выровнена, чтобы потоки не делили строку кэша)
+    struct alignas(64) BandBest {
+        int score = 0;
+        std::size_t index = 0;
+    };
+
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<int> map_;
+
+    std::unique_ptr<ThreadPool> pool_;   ///< nullptr — в вызывающем потоке
+    std::size_t columnChunk_ = 0;        ///< столбцов в полосе
+    std::size_t rowChunk_ = 0;           ///< строк в полосе
+
+    // Счётчики before текущей строки (по столбцу) и after строки
+    // (по строке на поток), см. LargeProbabilityMap.cpp
+    std::vector<int> columnBefore_;
+    std::vector<int> rowAfter_;
+
+    // Покрытие по месту в отрезке
+    std::vector<int> profile_;
+    std::size_t stride_ = 0;
+    int top_ = 0;                        ///< наибольшая длина корабля
+
+    mutable std::vector<BandBest> bandBest_;
+
+    void buildProfile(std::span<const int> weights);
+
+    template <class F>
+    void forBands(std::size_t count, std::size_t chunk, F&& body) const;
+};
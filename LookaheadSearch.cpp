@@ -0,0 +1,326 @@
+﻿#include "LookaheadSearch.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "InlineVector.h"
+#include "PosteriorSampler.h"
+
+namespace {
+
+    constexpr std::size_t Cells = Bitboard::Cells;
+
+    // Исходы выстрела
+    constexpr int Miss = 0;
+    constexpr int Hit = 1;
+    constexpr int Sunk = 2;
+
+    // Выборок в одном куске работы потока (между проверками бюджета — раунд)
+    constexpr std::uint64_t SamplesPerChunk = 64;
+
+    // Доля бюджета на предварительный проход глубины 1 (выбор кандидатов)
+    constexpr double PilotShare = 0.125;
+
+    // Наибольшее число кандидатов второго хода
+    constexpr std::size_t MaxCandidates = 32;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Оценка выстрела по вероятностям исходов
+    double value(SearchObjective objective, double hit, double sunk) noexcept {
+        const double miss = std::max(0.0, 1.0 - hit - sunk);
+        if (objective == SearchObjective::ExpectedHits)
+            return hit + sunk;
+
+        double entropy = 0.0;
+        for (double p : { miss, hit, sunk })
+            if (p > 0.0)
+                entropy -= p * std::log2(p);
+        return entropy;
+    }
+
+} // namespace
+
+// ------------------------------------------------------------
+// Накопители
+// ------------------------------------------------------------
+void LookaheadSearch::Accumulator::clear() noexcept {
+    total = 0.0;
+    std::fill(first.begin(), first.end(), 0.0);
+    std::fill(branch.begin(), branch.end(), 0.0);
+    std::fill(second.begin(), second.end(), 0.0);
+    nodes = 0;
+    accepted = 0;
+}
+
+void LookaheadSearch::Accumulator::merge(const Accumulator& other) noexcept {
+    total += other.total;
+    for (std::size_t i = 0; i < first.size(); ++i) first[i] += other.first[i];
+    for (std::size_t i = 0; i < branch.size(); ++i) branch[i] += other.branch[i];
+    for (std::size_t i = 0; i < second.size(); ++i) second[i] += other.second[i];
+    nodes += other.nodes;
+    accepted += other.accepted;
+}
+
+// ------------------------------------------------------------
+// Конструктор: потоки и накопители
+// ------------------------------------------------------------
+LookaheadSearch::LookaheadSearch(const SearchConfig& config)
+    : config_(config)
+{
+    config_.plies = std::clamp(config_.plies, 1, 2);
+    config_.candidates = std::clamp(config_.candidates, 1, static_cast<int>(MaxCandidates));
+    if (config_.seconds <= 0.0 && config_.nodes == 0)
+        config_.nodes = SearchConfig{}.nodes;
+
+    if (config_.threads != 1)
+        pool_ = std::make_unique<ThreadPool>(config_.threads);
+
+    const std::size_t k = static_cast<std::size_t>(config_.candidates);
+    auto allocate = [k](Accumulator& a) {
+        a.first.resize(Cells * Outcomes);
+        a.branch.resize(k * Outcomes);
+        a.second.resize(k * Outcomes * Cells * Outcomes);
+    };
+
+    partials_.resize(pool_ ? pool_->size() : 1);
+    for (Accumulator& a : partials_)
+        allocate(a);
+    allocate(total_);
+}
+
+LookaheadSearch::~LookaheadSearch() = default;
+
+// ------------------------------------------------------------
+// Поиск
+// ------------------------------------------------------------
+SearchResult LookaheadSearch::run(
+    const Board& board,
+    const ShotsGrid& shots,
+    std::uint64_t seed,
+    const std::atomic<bool>* cancel
+)
+{
+    const auto start = Clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(Clock::now() - start).count(); };
+    auto cancelled = [&] { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    SearchResult result;
+
+    // Клетки, по которым ещё можно стрелять
+    Bitboard open;
+    for (std::size_t y = 0; y < BOARD_SIZE; ++y)
+        for (std::size_t x = 0; x < BOARD_SIZE; ++x)
+            if (!shots[y][x])
+                open.set(Bitboard::indexOf(static_cast<int>(x), static_cast<int>(y)));
+    if (open.none())
+        return result;
+
+    const PosteriorSampler sampler(board);
+    const Bitboard& openHits = sampler.openHits();
+    const SearchObjective objective = config_.objective;
+
+    const double pilotSeconds = config_.seconds > 0.0 ? config_.seconds * PilotShare : 0.0;
+    const std::uint64_t pilotNodes = config_.nodes ? std::max<std::uint64_t>(1, static_cast<std::uint64_t>(config_.nodes * PilotShare)) : 0;
+
+    InlineVector<std::size_t, MaxCandidates> candidates;
+    total_.clear();
+
+    // Оценка первого выстрела в клетку c
+    auto firstValue = [&](std::size_t c) {
+        const double t = total_.total;
+        return value(objective, total_.first[c * Outcomes + Hit] / t, total_.first[c * Outcomes + Sunk] / t);
+    };
+
+    // Лучший выстрел по текущим накопителям
+    auto updateBest = [&] {
+        if (total_.total <= 0.0)
+            return;
+
+        double bestScore = -std::numeric_limits<double>::infinity();
+        std::size_t bestCell = Cells;
+
+        if (candidates.empty()) {
+            open.forEach([&](std::size_t c) {
+                const double score = firstValue(c);
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestCell = c;
+                }
+                });
+        }
+        else {
+            for (std::size_t k = 0; k < candidates.size(); ++k) {
+                const std::size_t c = candidates[k];
+
+                double branchTotal = 0.0;
+                for (int o = 0; o < Outcomes; ++o)
+                    branchTotal += total_.branch[k * Outcomes + o];
+                if (branchTotal <= 0.0)
+                    continue;
+
+                // Ожидание по исходам первого выстрела лучшего второго
+                double expected = 0.0;
+                for (int o = 0; o < Outcomes; ++o) {
+                    const double w = total_.branch[k * Outcomes + o];
+                    if (w <= 0.0)
+                        continue;
+
+                    const double* next = &total_.second[(k * Outcomes + o) * Cells * Outcomes];
+                    double bestNext = 0.0;
+                    open.forEach([&](std::size_t c2) {
+                        if (c2 == c)
+                            return;
+                        bestNext = std::max(bestNext,
+                            value(objective, next[c2 * Outcomes + Hit] / w, next[c2 * Outcomes + Sunk] / w));
+                        });
+                    expected += w / branchTotal * bestNext;
+                }
+
+                const double score = firstValue(c) + expected;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestCell = c;
+                }
+            }
+        }
+
+        if (bestCell == Cells)
+            return;
+
+        result.best = Coord(static_cast<int>(bestCell % BOARD_SIZE), static_cast<int>(bestCell / BOARD_SIZE));
+        result.score = bestScore;
+        result.valid = true;
+    };
+
+    // Выбор кандидатов второго хода по оценке глубины 1
+    auto chooseCandidates = [&] {
+        InlineVector<std::size_t, Cells> cells;
+        open.forEach([&](std::size_t c) { cells.push_back(c); });
+
+        const std::size_t k = std::min<std::size_t>(static_cast<std::size_t>(config_.candidates), cells.size());
+        std::partial_sort(cells.begin(), cells.begin() + k, cells.end(), [&](std::size_t a, std::size_t b) {
+            const double va = firstValue(a);
+            const double vb = firstValue(b);
+            return va != vb ? va > vb : a < b;
+            });
+
+        for (std::size_t i = 0; i < k; ++i)
+            candidates.push_back(cells[i]);
+    };
+
+    // Один кусок выборок в накопитель потока
+    auto sampleChunk = [&](Accumulator& acc, std::uint64_t round, std::size_t chunk, std::uint64_t count) {
+        std::mt19937 rng = chunkRng(seed, round, chunk);
+
+        FleetSample sample;
+        std::array<std::int8_t, Cells> shipOf;
+        shipOf.fill(-1);
+        std::array<int, SHIP_SIZES.size()> unknown{};
+
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (cancelled())
+                break;
+            if (config_.seconds > 0.0 && i % 16 == 15 && elapsed() >= config_.seconds)
+                break;
+
+            ++acc.nodes;
+            if (!sampler.draw(rng, sample))
+                continue;
+            ++acc.accepted;
+
+            const double w = sample.weight;
+            acc.total += w;
+
+            for (std::size_t s = 0; s < sample.bodies.size(); ++s) {
+                const Bitboard& body = sample.bodies[s];
+                unknown[s] = (body & ~openHits).count();
+                body.forEach([&](std::size_t c) { shipOf[c] = static_cast<std::int8_t>(s); });
+            }
+
+            // Исход выстрела в клетку c; skip — корабль, у которого клетка c2 уже подбита
+            auto outcome = [&](std::size_t c, int skipShip) {
+                const int s = shipOf[c];
+                if (s < 0)
+                    return Miss;
+                const int left = unknown[static_cast<std::size_t>(s)] - (s == skipShip ? 1 : 0);
+                return left == 1 ? Sunk : Hit;
+            };
+
+            const Bitboard targets = sample.ships & ~openHits;
+            targets.forEach([&](std::size_t c) {
+                acc.first[c * Outcomes + static_cast<std::size_t>(outcome(c, -1))] += w;
+                });
+
+            for (std::size_t k = 0; k < candidates.size(); ++k) {
+                const std::size_t c = candidates[k];
+                const int o = outcome(c, -1);
+                acc.branch[k * Outcomes + static_cast<std::size_t>(o)] += w;
+
+                double* next = &acc.second[(k * Outcomes + static_cast<std::size_t>(o)) * Cells * Outcomes];
+                const int ship = shipOf[c];
+                targets.forEach([&](std::size_t c2) {
+                    if (c2 != c)
+                        next[c2 * Outcomes + static_cast<std::size_t>(outcome(c2, ship))] += w;
+                    });
+            }
+
+            sample.ships.forEach([&](std::size_t c) { shipOf[c] = -1; });
+        }
+    };
+
+    // Раунды до исчерпания бюджета. Накопитель у каждой порции свой,
+    // и складываются они по порядку порций — сумма не зависит от того,
+    // какой поток какую порцию взял.
+    const std::size_t chunks = partials_.size();
+    for (std::uint64_t round = 0;; ++round) {
+        std::uint64_t perChunk = SamplesPerChunk;
+        if (config_.nodes) {
+            const std::uint64_t left = config_.nodes - total_.nodes;
+            perChunk = std::clamp<std::uint64_t>((left + chunks - 1) / chunks, 1, SamplesPerChunk);
+        }
+
+        for (Accumulator& a : partials_)
+            a.clear();
+
+        if (pool_) {
+            pool_->parallelFor(chunks, 1, [&](std::size_t begin, std::size_t end, unsigned) {
+                for (std::size_t chunk = begin; chunk < end; ++chunk)
+                    sampleChunk(partials_[chunk], round, chunk, perChunk);
+                });
+        }
+        else {
+            sampleChunk(partials_[0], round, 0, perChunk);
+        }
+
+        for (const Accumulator& a : partials_)
+            total_.merge(a);
+        updateBest();
+
+        // Конец предварительного прохода — раскрываем лучшие клетки на второй ход
+        if (config_.plies == 2 && candidates.empty() && total_.total > 0.0) {
+            const bool pilotDone =
+                (pilotNodes && total_.nodes >= pilotNodes) ||
+                (pilotSeconds > 0.0 && elapsed() >= pilotSeconds);
+            if (pilotDone)
+                chooseCandidates();
+        }
+
+        if (cancelled()) {
+            result.interrupted = true;
+            break;
+        }
+        if (config_.nodes && total_.nodes >= config_.nodes)
+            break;
+        if (config_.seconds > 0.0 && elapsed() >= config_.seconds)
+            break;
+    }
+
+    result.nodes = total_.nodes;
+    result.accepted = total_.accepted;
+    result.seconds = elapsed();
+    return result;
+}
@@ -0,0 +1,113 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Board.h"
+#include "Coord.h"
+#include "ShotsGrid.h"
+#include "ThreadPool.h"
+
+// Что максимизирует поиск
+enum class SearchObjective {
+    ExpectedHits,       ///< ожидаемое число попаданий (меньше выстрелов до победы)
+    InformationGain     ///< энтропия исхода выстрела (промах / попадание / затопление);
+                        ///< в прогонах battleship_sim заметно слабее ExpectedHits
+};
+
+/**
+ * @struct SearchConfig
+ * @brief Параметры упреждающего поиска.
+ *
+ * Бюджет задаётся временем, числом узлов (выборок расстановок)
+ * или обоими; поиск останавливается по первому исчерпанному.
+ */
+struct SearchConfig {
+    double seconds = 0.0;           ///< бюджет времени (0 — без ограничения)
+    std::uint64_t nodes = 20000;    ///< бюджет выборок (0 — без ограничения)
+    int plies = 2;                  ///< глубина: 1 или 2 выстрела
+    int candidates = 12;            ///< сколько лучших клеток первого хода раскрывать на второй
+    unsigned threads = 1;           ///< потоки поиска (0 — по числу ядер)
+    SearchObjective objective = SearchObjective::ExpectedHits;
+};
+
+/**
+ * @struct SearchResult
+ * @brief Лучший найденный выстрел и статистика поиска.
+ */
+struct SearchResult {
+    Coord best;
+    bool valid = false;             ///< найдена хотя бы одна согласованная расстановка
+    bool interrupted = false;       ///< остановлен флагом отмены
+    double score = 0.0;             ///< оценка лучшего выстрела
+    std::uint64_t nodes = 0;        ///< вытянуто расстановок
+    std::uint64_t accepted = 0;     ///< из них согласованных
+    double seconds = 0.0;
+};
+
+/**
+ * @class LookaheadSearch
+ * @brief Выбор выстрела ИИ ожидаемой оценкой на 1–2 хода вперёд.
+ *
+ * Тянет расстановки оставшихся кораблей, согласованные с тем, что
+ * видит ИИ (PosteriorSampler), и по ним оценивает исход каждого
+ * выстрела. На глубине 2 для нескольких лучших клеток первого хода
+ * исходы разбиваются по результату (промах / попадание / затопление),
+ * и к оценке прибавляется ожидаемая оценка лучшего второго выстрела
+ * (expectimax).
+ *
+ * Поиск идёт раундами: потоки тянут выборки в свои накопители,
+ * между раундами накопители сливаются и пересчитывается лучший
+ * выстрел. Поэтому прерванный поиск всегда возвращает лучшее на
+ * момент прерывания.
+ */
+class LookaheadSearch {
+public:
+    explicit LookaheadSearch(const SearchConfig& config);
+    ~LookaheadSearch();
+
+    LookaheadSearch(const LookaheadSearch&) = delete;
+    LookaheadSearch& operator=(const LookaheadSearch&) = delete;
+
+    /**
+     * @param board   поле противника (используются только видимые ИИ маски)
+     * @param shots   клетки, по которым ИИ уже стрелял или которые закрыл
+     * @param seed    зерно выборок (одинаковое зерно и бюджет узлов — одинаковый ответ)
+     * @param cancel  флаг прерывания (может быть nullptr)
+     */
+    [[nodiscard]]
+    SearchResult run(
+        const Board& board,
+        const ShotsGrid& shots,
+        std::uint64_t seed,
+        const std::atomic<bool>* cancel = nullptr
+    );
+
+    [[nodiscard]]
+    const SearchConfig& config() const noexcept { return config_; }
+
+private:
+    // Исход выстрела
+    static constexpr int Outcomes = 3;    // промах, попадание, затопление
+
+    // Накопитель одного потока
+    struct Accumulator {
+        double total = 0.0;
+        std::vector<double> first;        ///< [клетка][исход] — исходы первого выстрела
+        std::vector<double> branch;       ///< [кандидат][исход] — вес ветви
+        std::vector<double> second;       ///< [кандидат][исход][клетка][исход] — исходы второго выстрела
+        std::uint64_t nodes = 0;
+        std::uint64_t accepted = 0;
+
+        void clear() noexcept;
+        void merge(const Accumulator& other) noexcept;
+    };
+
+    SearchConfig config_;
+    std::unique_ptr<ThreadPool> pool_;    ///< nullptr — поиск в вызывающем потоке
+    std::vector<Accumulator> partials_;   ///< по одному на порцию раунда
+    Accumulator total_;
+};
@@ -0,0 +1,92 @@
+﻿#include "MonteCarloMap.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "PosteriorSampler.h"
+
+namespace {
+
+    // Выборок в одном куске работы потока
+    constexpr std::uint64_t SamplesPerChunk = 256;
+
+} // namespace
+
+// ------------------------------------------------------------
+// Конструктор: потоки и накопители
+// ------------------------------------------------------------
+MonteCarloMap::MonteCarloMap(const MonteCarloConfig& config)
+    : config_(config)
+{
+    if (config_.samples == 0)
+        config_.samples = MonteCarloConfig{}.samples;
+
+    if (config_.threads != 1)
+        pool_ = std::make_unique<ThreadPool>(config_.threads);
+    partials_.resize(static_cast<std::size_t>((config_.samples + SamplesPerChunk - 1) / SamplesPerChunk));
+}
+
+MonteCarloMap::~MonteCarloMap() = default;
+
+// ------------------------------------------------------------
+// Пересчёт
+// ------------------------------------------------------------
+bool MonteCarloMap::compute(const Board& board, std::uint64_t seed) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+
+    const PosteriorSampler sampler(board);
+    for (Accumulator& a : partials_)
+        a = Accumulator{};
+
+    // Накопитель у каждого куска свой, и складываются они по порядку
+    // кусков — сумма не зависит от того, какой поток какой кусок взял
+    auto sampleChunks = [&](std::size_t begin, std::size_t end, unsigned) {
+        FleetSample sample;
+
+        for (std::size_t chunk = begin; chunk < end; ++chunk) {
+            Accumulator& acc = partials_[chunk];
+            std::mt19937 rng = chunkRng(seed, 0, chunk);
+            const std::uint64_t first = chunk * SamplesPerChunk;
+            const std::uint64_t count = std::min(SamplesPerChunk, config_.samples - first);
+
+            for (std::uint64_t i = 0; i < count; ++i) {
+                ++acc.samples;
+                if (!sampler.draw(rng, sample))
+                    continue;
+                ++acc.accepted;
+
+                const double w = sample.weight;
+                acc.weight += w;
+                acc.weightSquared += w * w;
+                sample.ships.forEach([&](std::size_t c) { acc.occupancy[c] += w; });
+            }
+        }
+    };
+
+    const std::size_t chunks = partials_.size();
+    if (pool_)
+        pool_->parallelFor(chunks, 1, sampleChunks);
+    else
+        sampleChunks(0, chunks, 0);
+
+    // Сложение накопителей
+    Accumulator total;
+    for (const Accumulator& a : partials_) {
+        for (std::size_t c = 0; c < total.occupancy.size(); ++c)
+            total.occupancy[c] += a.occupancy[c];
+        total.weight += a.weight;
+        total.weightSquared += a.weightSquared;
+        total.samples += a.samples;
+        total.accepted += a.accepted;
+    }
+
+    for (std::size_t c = 0; c < total.occupancy.size(); ++c)
+        map[c / BOARD_SIZE][c % BOARD_SIZE] = total.weight > 0.0 ? total.occupancy[c] / total.weight : 0.0;
+
+    stats_.samples = total.samples;
+    stats_.accepted = total.accepted;
+    stats_.effective = total.weightSquared > 0.0 ? total.weight * total.weight / total.weightSquared : 0.0;
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return total.weight > 0.0;
+}
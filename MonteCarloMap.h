@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Board.h"
+#include "GameConfig.h"
+#include "ThreadPool.h"
+
+/**
+ * @struct MonteCarloConfig
+ * @brief Параметры карты Монте-Карло.
+ */
+struct MonteCarloConfig {
+    std::uint64_t samples = 20000;   ///< выборок расстановок на один пересчёт
+    unsigned threads = 1;            ///< потоки (0 — по числу ядер)
+};
+
+/**
+ * @struct MonteCarloStats
+ * @brief Статистика последнего пересчёта.
+ */
+struct MonteCarloStats {
+    std::uint64_t samples = 0;     ///< вытянуто расстановок
+    std::uint64_t accepted = 0;    ///< из них согласованных
+    double effective = 0.0;        ///< эффективный размер выборки (sum w)^2 / sum w^2
+    double seconds = 0.0;
+
+    /**
+     * @brief Скорость выборки — по ней подбирается samples под нужную задержку хода.
+     */
+    [[nodiscard]]
+    double samplesPerSecond() const noexcept {
+        return seconds > 0.0 ? static_cast<double>(samples) / seconds : 0.0;
+    }
+};
+
+/**
+ * @class MonteCarloMap
+ * @brief Апостериорная карта: частота занятости клеток по выборкам
+ *        расстановок, согласованных с наблюдениями.
+ *
+ * В отличие от ProbabilityMap учитывает запрет касания кораблей,
+ * то, что попадания должны быть покрыты, и какие корабли уже
+ * затоплены. Выборки тянет PosteriorSampler кусками по 256; каждый
+ * кусок копит взвешенные частоты в свой накопитель, в конце накопители
+ * складываются по порядку кусков, поэтому карта зависит только от seed,
+ * а не от числа потоков. С ростом samples карта сходится к точной
+ * вероятности занятости клетки.
+ */
+class MonteCarloMap {
+public:
+    // Вероятность корабля в клетке (0, если нет ни одной согласованной выборки)
+    std::array<std::array<double, BOARD_SIZE>, BOARD_SIZE> map{};
+
+    explicit MonteCarloMap(const MonteCarloConfig& config);
+    ~MonteCarloMap();
+
+    MonteCarloMap(const MonteCarloMap&) = delete;
+    MonteCarloMap& operator=(const MonteCarloMap&) = delete;
+
+    /**
+     * @brief Пересчитывает карту по видимым ИИ маскам поля.
+     *
+     * @return false  Не нашлось ни одной согласованной расстановки
+     */
+    bool compute(const Board& board, std::uint64_t seed) noexcept;
+
+    [[nodiscard]]
+    const MonteCarloStats& stats() const noexcept { return stats_; }
+
+    [[nodiscard]]
+    const MonteCarloConfig& config() const noexcept { return config_; }
+
+private:
+    // Накопитель одного куска выборок (выровнен, чтобы потоки не делили строку кэша)
+    struct alignas(64) Accumulator {
+        std::array<double, Bitboard::Cells> occupancy{};
+        double weight = 0.0;
+        double weightSquared = 0.0;
+        std::uint64_t samples = 0;
+        std::uint64_t accepted = 0;
+    };
+
+    MonteCarloConfig config_;
+    std::unique_ptr<ThreadPool> pool_;     ///< nullptr — в вызывающем потоке
+    std::vector<Accumulator> partials_;    ///< по одному на кусок SamplesPerChunk выборок
+    MonteCarloStats stats_;
+};
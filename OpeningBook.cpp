@@ -0,0 +1,292 @@
+﻿#include "OpeningBook.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+#include "AIController.h"
+#include "Board.h"
+#include "ThreadPool.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ------------------------------------------------------------
+// Формат файла
+// ------------------------------------------------------------
+namespace {
+
+    constexpr std::array<char, 8> Magic{ 'B', 'S', 'H', 'P', 'B', 'O', 'O', 'K' };
+    constexpr std::uint32_t EndianMark = 0x01020304u;
+
+    struct BookHeader {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t endian;      ///< EndianMark в порядке байт писавшей машины
+        std::uint32_t boardSize;
+        std::uint32_t words;       ///< слов в Bitboard
+        std::uint64_t fleet;       ///< отпечаток SHIP_SIZES
+        std::uint64_t keys;        ///< отпечаток Zobrist-ключей Board
+        std::uint64_t count;       ///< записей
+        std::uint32_t depth;       ///< глубина, с которой строилась книга
+        std::uint32_t reserved;
+        std::uint64_t ai;          ///< отпечаток настроек выбора хода
+    };
+
+    // FNV-1a по длинам кораблей
+    std::uint64_t fleetFingerprint() noexcept {
+        std::uint64_t h = 0xCBF29CE484222325ull;
+        for (int len : SHIP_SIZES)
+            h = (h ^ static_cast<std::uint64_t>(len)) * 0x100000001B3ull;
+        return h;
+    }
+
+    // FNV-1a по способу выбора хода и его бюджету. Потоки не входят:
+    // книга строится в один поток на партию, а игра ищет в несколько.
+    // Бюджет времени — в миллисекундах, как у --search-ms.
+    std::uint64_t aiFingerprint(const AiSettings& ai) noexcept {
+        std::uint64_t h = 0xCBF29CE484222325ull;
+        auto mix = [&](std::uint64_t value) { h = (h ^ value) * 0x100000001B3ull; };
+
+        mix(ai.search ? 1 : 0);
+        if (ai.search) {
+            mix(static_cast<std::uint64_t>(std::llround(ai.search->seconds * 1000.0)));
+            mix(ai.search->nodes);
+            mix(static_cast<std::uint64_t>(ai.search->plies));
+            mix(static_cast<std::uint64_t>(ai.search->candidates));
+            mix(static_cast<std::uint64_t>(ai.search->objective));
+        }
+        mix(ai.monteCarlo ? 1 : 0);
+        if (ai.monteCarlo)
+            mix(ai.monteCarlo->samples);
+        return h;
+    }
+
+    // Хеш двух промахов на пустом поле: меняется вместе с ключами
+    std::uint64_t keysFingerprint() noexcept {
+        Board board;
+        (void)board.shoot(0, 0);
+        (void)board.shoot(static_cast<int>(BOARD_SIZE) - 1, static_cast<int>(BOARD_SIZE) - 1);
+        return board.observedHash();
+    }
+
+    BookHeader expectedHeader(std::uint64_t count, int depth, std::uint64_t ai) noexcept {
+        BookHeader h{};
+        h.magic = Magic;
+        h.version = OpeningBook::Version;
+        h.endian = EndianMark;
+        h.boardSize = static_cast<std::uint32_t>(BOARD_SIZE);
+        h.words = static_cast<std::uint32_t>(Bitboard::Words);
+        h.fleet = fleetFingerprint();
+        h.keys = keysFingerprint();
+        h.count = count;
+        h.depth = static_cast<std::uint32_t>(depth);
+        h.ai = ai;
+        return h;
+    }
+
+} // namespace
+
+struct OpeningBook::Entry {
+    std::uint64_t key;
+    std::array<std::uint64_t, Bitboard::Words> cells;
+};
+
+static_assert(std::is_trivially_copyable_v<BookHeader> && sizeof(BookHeader) % alignof(std::uint64_t) == 0);
+
+// ------------------------------------------------------------
+// Построение самоигрой
+// ------------------------------------------------------------
+std::vector<OpeningBookEntry> generateOpeningBook(const OpeningBookConfig& config) {
+    ThreadPool pool(config.threads);
+
+    // С запасом по слотам, чтобы совпадения вытесняли мало состояний
+    constexpr std::size_t MaxSlots = std::size_t{ 1 } << 22;
+    const std::size_t states = static_cast<std::size_t>(config.games) * static_cast<std::size_t>(std::max(config.depth, 0));
+    ShotCache recorder(std::clamp<std::size_t>(std::bit_ceil(states + 1) * 4, 1024, MaxSlots));
+
+    AiSettings settings = config.ai;
+    if (settings.search)
+        settings.search->threads = 1;
+    if (settings.monteCarlo)
+        settings.monteCarlo->threads = 1;
+    settings.cache = &recorder;
+    settings.book = nullptr;
+
+    pool.parallelFor(config.games, 64, [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t game = begin; game < end; ++game) {
+            std::mt19937 rng = gameRng(config.seed, game);
+            Board board;
+            board.randomPlaceFleet(rng);
+
+            AIController ai(rng);
+            configureAi(ai, settings);
+
+            ShotsGrid shots{};
+            bool playerTurn = false;
+            bool playerWon = false;
+            for (int turn = 0; turn < config.depth; ++turn)
+                if (ai.takeTurn(board, shots, playerTurn, playerWon))
+                    break;
+        }
+        });
+
+    std::vector<OpeningBookEntry> entries;
+    recorder.forEach([&](std::uint64_t key, const Bitboard& best) { entries.emplace_back(key, best); });
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return entries;
+}
+
+// ------------------------------------------------------------
+// Запись
+// ------------------------------------------------------------
+bool OpeningBook::write(
+    const std::string& path,
+    const std::vector<OpeningBookEntry>& entries,
+    int depth,
+    const AiSettings& ai
+) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Не удалось создать " << path << '\n';
+        return false;
+    }
+
+    const BookHeader header = expectedHeader(entries.size(), depth, aiFingerprint(ai));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& [key, best] : entries) {
+        const Entry entry{ key, best.words() };
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    if (!out) {
+        std::cerr << "Ошибка записи " << path << '\n';
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Отображение в память
+// ------------------------------------------------------------
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+bool OpeningBook::open(const std::string& path, const AiSettings& ai) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "Не удалось отобразить " << path << '\n';
+        return false;
+    }
+
+    file_ = file;
+    mapping_ = mapping;
+    view_ = view;
+    bytes_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st {};
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // отображение живёт и без дескриптора
+
+    if (view == MAP_FAILED) {
+        std::cerr << "Не удалось отобразить " << path << '\n';
+        return false;
+    }
+
+    view_ = view;
+    bytes_ = static_cast<std::size_t>(st.st_size);
+#endif
+
+    // Проверяется только заголовок — записи не разбираются
+    BookHeader header{};
+    bool valid = bytes_ >= sizeof(header);
+    if (valid)
+        std::memcpy(&header, view_, sizeof(header));
+
+    const BookHeader expected = expectedHeader(header.count, static_cast<int>(header.depth), header.ai);
+    if (!valid || std::memcmp(&header, &expected, sizeof(header)) != 0 ||
+        (bytes_ - sizeof(header)) / sizeof(Entry) != header.count ||
+        (bytes_ - sizeof(header)) % sizeof(Entry) != 0)
+    {
+        std::cerr << "Дебютная книга " << path << " не подходит (другая версия, поле или флот)\n";
+        close();
+        return false;
+    }
+
+    if (header.ai != aiFingerprint(ai)) {
+        std::cerr << "Дебютная книга " << path << " построена с другими настройками ИИ (поиск или Монте-Карло)\n";
+        close();
+        return false;
+    }
+
+    entries_ = reinterpret_cast<const Entry*>(static_cast<const char*>(view_) + sizeof(header));
+    count_ = static_cast<std::size_t>(header.count);
+    return true;
+}
+
+void OpeningBook::close() noexcept {
+#ifdef _WIN32
+    if (view_)
+        UnmapViewOfFile(view_);
+    if (mapping_)
+        CloseHandle(mapping_);
+    if (file_)
+        CloseHandle(file_);
+    file_ = nullptr;
+    mapping_ = nullptr;
+#else
+    if (view_)
+        munmap(const_cast<void*>(view_), bytes_);
+#endif
+    view_ = nullptr;
+    bytes_ = 0;
+    entries_ = nullptr;
+    count_ = 0;
+}
+
+// ------------------------------------------------------------
+// Поиск
+// ------------------------------------------------------------
+std::optional<Bitboard> OpeningBook::find(std::uint64_t key) const noexcept {
+    const Entry* end = entries_ + count_;
+    const Entry* it = std::lower_bound(entries_, end, key, [](const Entry& e, std::uint64_t k) { return e.key < k; });
+    if (it == end || it->key != key)
+        return std::nullopt;
+    return Bitboard::fromWords(it->cells);
+}
@@ -0,0 +1,112 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bitboard.h"
+#include "Simulation.h"
+
+/**
+ * @struct OpeningBookConfig
+ * @brief Параметры построения дебютной книги.
+ */
+struct OpeningBookConfig {
+    std::uint64_t games = 20000;   ///< партий самоигры
+    int depth = 8;                 ///< записываются первые depth ходов каждой партии
+    std::uint64_t seed = 1;
+    unsigned threads = 0;          ///< 0 — по числу ядер
+    AiSettings ai;                 ///< ИИ, чьи ходы записываются (cache игнорируется)
+};
+
+// Запись книги: ключ выбора (как в ShotCache) и лучшие клетки
+using OpeningBookEntry = std::pair<std::uint64_t, Bitboard>;
+
+/**
+ * @brief Строит книгу самоигрой: ИИ с настройками config.ai играет
+ *        config.games партий по config.depth ходов, каждый выбор
+ *        по карте (или поиску) записывается.
+ *
+ * Записи собирает ShotCache с запасом по размеру; состояния, вытесненные
+ * при совпадении слотов, в книгу не попадают. Результат упорядочен по ключу.
+ */
+[[nodiscard]]
+std::vector<OpeningBookEntry> generateOpeningBook(const OpeningBookConfig& config);
+
+/**
+ * @class OpeningBook
+ * @brief Дебютная книга «видимое состояние -> лучшие клетки»,
+ *        отображённая в память только для чтения.
+ *
+ * Формат файла (little-endian): заголовок BookHeader, затем записи
+ * { ключ, слова Bitboard } по возрастанию ключа. open() проверяет
+ * только заголовок — размер поля, флот, Zobrist-ключи, версию и
+ * отпечаток настроек выбора хода (жадный выбор, глубина и бюджет поиска,
+ * выборки Монте-Карло; потоки не входят), —
+ * поэтому открывается мгновенно при любом размере книги; поиск —
+ * двоичный по отображённым записям. Страницы файла общие для всех
+ * процессов, открывших ту же книгу.
+ */
+class OpeningBook {
+public:
+    // Текущая версия формата; другая версия не открывается
+    static constexpr std::uint32_t Version = 2;
+
+    OpeningBook() = default;
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    /**
+     * @brief Отображает файл книги для ИИ с настройками ai.
+     *
+     * @return false — файла нет или он не подходит, в том числе построен
+     *         с другими настройками выбора хода (причина — в std::cerr,
+     *         кроме отсутствующего файла); книга остаётся закрытой.
+     */
+    bool open(const std::string& path, const AiSettings& ai);
+
+    void close() noexcept;
+
+    [[nodiscard]]
+    bool isOpen() const noexcept { return entries_ != nullptr; }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept { return count_; }
+
+    /**
+     * @brief Лучшие клетки для ключа (std::nullopt — нет в книге).
+     */
+    [[nodiscard]]
+    std::optional<Bitboard> find(std::uint64_t key) const noexcept;
+
+    /**
+     * @brief Записывает книгу (entries упорядочены по ключу), построенную
+     *        ИИ с настройками ai.
+     *
+     * @return false — ошибка записи (причина — в std::cerr)
+     */
+    static bool write(
+        const std::string& path,
+        const std::vector<OpeningBookEntry>& entries,
+        int depth,
+        const AiSettings& ai
+    );
+
+private:
+    struct Entry;
+
+    const void* view_ = nullptr;       ///< отображение всего файла
+    std::size_t bytes_ = 0;
+    const Entry* entries_ = nullptr;
+    std::size_t count_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;             ///< HANDLE файла
+    void* mapping_ = nullptr;          ///< HANDLE отображения
+#endif
+};
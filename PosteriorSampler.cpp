@@ -0,0 +1,87 @@
+﻿#include "PosteriorSampler.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "ConstraintPropagation.h"
+#include "ShipPlacements.h"
+
+// ------------------------------------------------------------
+// Генератор куска выборок
+// ------------------------------------------------------------
+namespace {
+
+    constexpr std::uint64_t splitMix64(std::uint64_t x) noexcept {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+} // namespace
+
+std::mt19937 chunkRng(std::uint64_t seed, std::uint64_t round, std::uint64_t chunk) noexcept {
+    const std::uint64_t mixed = splitMix64(splitMix64(splitMix64(seed) ^ round) ^ chunk);
+    return std::mt19937(static_cast<std::uint32_t>(mixed));
+}
+
+// ------------------------------------------------------------
+// Наблюдения ИИ
+// ------------------------------------------------------------
+PosteriorSampler::PosteriorSampler(const Board& board) noexcept
+    : blocked_(propagateConstraints(board).blocked),
+    openHits_(board.hits() & ~board.sunk()),
+    remaining_(remainingLengths(board.sunk()))
+{
+}
+
+ShipLengths PosteriorSampler::remainingLengths(const Bitboard& sunk) noexcept {
+    return remainingShipLengths<ClassicRules>(sunk);
+}
+
+ShipLengths PosteriorSampler::sunkLengths(const Bitboard& sunk) noexcept {
+    return sunkShipLengths<ClassicRules>(sunk);
+}
+
+// ------------------------------------------------------------
+// Одна выборка
+// ------------------------------------------------------------
+bool PosteriorSampler::draw(std::mt19937& rng, FleetSample& out) const noexcept {
+    out.ships = {};
+    out.bodies.clear();
+    out.weight = 0.0;
+
+    Bitboard blocked = blocked_;
+    double weight = 1.0;
+    InlineVector<const ShipPlacement*, MAX_PLACEMENTS_PER_LENGTH> options;
+
+    for (int len : remaining_) {
+        options.clear();
+        for (const ShipPlacement& p : shipPlacements(len)) {
+            if ((p.body & blocked).any())
+                continue;
+            if ((p.ring & openHits_).any())
+                continue;
+            if ((p.body & ~openHits_).none())
+                continue;
+            options.push_back(&p);
+        }
+
+        if (options.empty())
+            return false;
+
+        std::uniform_int_distribution<std::size_t> pick(0, options.size() - 1);
+        const ShipPlacement& chosen = *options[pick(rng)];
+
+        weight *= static_cast<double>(options.size());
+        blocked |= chosen.halo;
+        out.ships |= chosen.body;
+        out.bodies.push_back(chosen.body);
+    }
+
+    if ((openHits_ & ~out.ships).any())
+        return false;
+
+    out.weight = weight;
+    return true;
+}
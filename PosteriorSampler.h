@@ -0,0 +1,101 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include "Bitboard.h"
+#include "Board.h"
+#include "GameConfig.h"
+#include "InlineVector.h"
+
+// Список длин кораблей флота
+using ShipLengths = BasicShipLengths<ClassicRules>;
+
+/**
+ * @brief Генератор куска выборок: зависит только от seed, раунда и номера куска,
+ *        поэтому результат не зависит от того, какой поток взял кусок.
+ *
+ * Зерно перемешивается splitmix64 (std::seed_seq выделял бы память).
+ */
+[[nodiscard]]
+std::mt19937 chunkRng(std::uint64_t seed, std::uint64_t round, std::uint64_t chunk) noexcept;
+
+/**
+ * @struct FleetSample
+ * @brief Одна расстановка оставшихся кораблей, согласованная с наблюдениями.
+ */
+struct FleetSample {
+    Bitboard ships;                                      ///< палубы всех оставшихся кораблей
+    InlineVector<Bitboard, SHIP_SIZES.size()> bodies;    ///< палубы каждого корабля
+    double weight = 0.0;                                 ///< вес выборки (0 — отброшена)
+};
+
+/**
+ * @class PosteriorSampler
+ * @brief Случайные расстановки флота, не противоречащие тому, что видит ИИ.
+ *
+ * Из поля берутся только видимые ИИ маски: промахи, попадания и
+ * затопленные палубы. Затопленные корабли (с окружением) исключаются,
+ * остальные корабли ставятся по одному, от длинных к коротким:
+ *  - не на промахи, не рядом с затопленными и не на воду, выведенную
+ *    propagateConstraints (так тупиковые варианты отсекаются заранее);
+ *  - не касаясь уже поставленных;
+ *  - не касаясь чужих попаданий и не целиком на попаданиях
+ *    (такой корабль был бы уже затоплен).
+ * В конце каждое открытое попадание должно быть покрыто.
+ *
+ * Каждый корабль выбирается равновероятно из допустимых положений,
+ * а вес выборки — произведение числа вариантов на каждом шаге
+ * (оценка Розенблюта). Поэтому средние, взвешенные по weight,
+ * сходятся к средним по равномерному распределению всех согласованных
+ * расстановок, хотя сами выборки распределены неравномерно.
+ */
+class PosteriorSampler {
+public:
+    explicit PosteriorSampler(const Board& board) noexcept;
+
+    /**
+     * @brief Тянет одну расстановку.
+     *
+     * @return false  Тупик или не покрыто попадание (out.weight = 0)
+     */
+    bool draw(std::mt19937& rng, FleetSample& out) const noexcept;
+
+    /**
+     * @brief Клетки, закрытые для оставшихся кораблей.
+     */
+    [[nodiscard]]
+    const Bitboard& blocked() const noexcept { return blocked_; }
+
+    /**
+     * @brief Попадания по ещё не затопленным кораблям.
+     */
+    [[nodiscard]]
+    const Bitboard& openHits() const noexcept { return openHits_; }
+
+    /**
+     * @brief Длины оставшихся кораблей, по убыванию.
+     */
+    [[nodiscard]]
+    const ShipLengths& remaining() const noexcept { return remaining_; }
+
+    /**
+     * @brief Длины затопленных кораблей по маске затопленных палуб.
+     *
+     * Корабли не соприкасаются, поэтому каждая прямая цепочка
+     * затопленных палуб — ровно один корабль.
+     */
+    [[nodiscard]]
+    static ShipLengths sunkLengths(const Bitboard& sunk) noexcept;
+
+    /**
+     * @brief Длины оставшихся кораблей (SHIP_SIZES минус затопленные), по убыванию.
+     */
+    [[nodiscard]]
+    static ShipLengths remainingLengths(const Bitboard& sunk) noexcept;
+
+private:
+    Bitboard blocked_;     ///< промахи, затопленные с окружением и выведенная вода (ConstraintPropagation.h)
+    Bitboard openHits_;    ///< попадания без затопленных
+    ShipLengths remaining_;
+};
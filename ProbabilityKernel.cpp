@@ -0,0 +1,249 @@
+﻿#include "ProbabilityKernel.h"
+#include "ProbabilityKernelImpl.h"
+
+#if BATTLESHIP_KERNEL_X86
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+namespace {
+
+    // ------------------------------------------------------------
+    //  Скалярная версия: пара масок Bitboard
+    // ------------------------------------------------------------
+    struct ScalarOps {
+        struct Vec {
+            Bitboard horizontal;
+            Bitboard vertical;
+        };
+
+        static Vec zero() noexcept { return {}; }
+        static Vec bitAnd(const Vec& a, const Vec& b) noexcept { return { a.horizontal & b.horizontal, a.vertical & b.vertical }; }
+        static Vec bitXor(const Vec& a, const Vec& b) noexcept { return { a.horizontal ^ b.horizontal, a.vertical ^ b.vertical }; }
+        static Vec back(const Vec& a) noexcept { return { a.horizontal.west(), a.vertical.north() }; }
+        static Vec forward(const Vec& a) noexcept { return { a.horizontal.east(), a.vertical.south() }; }
+    };
+
+#if BATTLESHIP_KERNEL_X86
+
+    // ------------------------------------------------------------
+    //  SSE2: каждая маска — один 128-битный регистр
+    // ------------------------------------------------------------
+    template <int N>
+    __m128i shiftLeft(__m128i a) noexcept {
+        return _mm_or_si128(_mm_slli_epi64(a, N), _mm_srli_epi64(_mm_slli_si128(a, 8), 64 - N));
+    }
+
+    template <int N>
+    __m128i shiftRight(__m128i a) noexcept {
+        return _mm_or_si128(_mm_srli_epi64(a, N), _mm_slli_epi64(_mm_srli_si128(a, 8), 64 - N));
+    }
+
+    __m128i words(std::uint64_t lo, std::uint64_t hi) noexcept {
+        return _mm_set_epi64x(static_cast<long long>(hi), static_cast<long long>(lo));
+    }
+
+    struct Sse2Ops {
+        struct Vec {
+            __m128i horizontal;
+            __m128i vertical;
+        };
+
+        static Vec zero() noexcept { return { _mm_setzero_si128(), _mm_setzero_si128() }; }
+        static Vec bitAnd(Vec a, Vec b) noexcept { return { _mm_and_si128(a.horizontal, b.horizontal), _mm_and_si128(a.vertical, b.vertical) }; }
+        static Vec bitXor(Vec a, Vec b) noexcept { return { _mm_xor_si128(a.horizontal, b.horizontal), _mm_xor_si128(a.vertical, b.vertical) }; }
+
+        static Vec back(Vec a) noexcept {
+            const __m128i h = _mm_and_si128(a.horizontal, words(kernel::NoFirstLo, kernel::NoFirstHi));
+            return { shiftRight<1>(h), shiftRight<kernel::Width>(a.vertical) };
+        }
+
+        static Vec forward(Vec a) noexcept {
+            const __m128i board = words(kernel::BoardLo, kernel::BoardHi);
+            const __m128i h = _mm_and_si128(a.horizontal, words(kernel::NoLastLo, kernel::NoLastHi));
+            return {
+                _mm_and_si128(shiftLeft<1>(h), board),
+                _mm_and_si128(shiftLeft<kernel::Width>(a.vertical), board)
+            };
+        }
+    };
+
+    // ------------------------------------------------------------
+    //  Проверка AVX2 (инструкции CPU и сохранение регистров ОС)
+    // ------------------------------------------------------------
+    bool cpuHasAvx2() noexcept {
+#if defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif
+
+    // ------------------------------------------------------------
+    //  Срезы -> числа в клетках
+    //
+    //  Сначала горизонтальные и вертикальные срезы складываются
+    //  побитовым сумматором (сумма не больше MaxCoverage и помещается
+    //  в те же Planes срезов). Затем по 8 клеток за раз: каждый бит
+    //  среза раскладывается в свой байт (таблица Spread), байты копят
+    //  сумму без переносов.
+    // ------------------------------------------------------------
+    static_assert((1 << kernel::Planes) <= 256, "Покрытие клетки не помещается в байт");
+
+    constexpr auto Spread = [] {
+        std::array<std::uint64_t, 256> table{};
+        for (int b = 0; b < 256; ++b)
+            for (int i = 0; i < 8; ++i)
+                if ((b >> i) & 1)
+                    table[b] |= std::uint64_t{ 1 } << (8 * i);
+        return table;
+    }();
+
+    using Planes = std::array<std::array<Bitboard, 2>, kernel::Planes>;
+
+    void expandPlanes(const Planes& planes, CoverageMap& out) noexcept {
+        std::array<Bitboard, kernel::Planes> total;
+        Bitboard carry;
+        for (int k = 0; k < kernel::Planes; ++k) {
+            const Bitboard& a = planes[k][0];
+            const Bitboard& b = planes[k][1];
+            total[k] = a ^ b ^ carry;
+            carry = (a & b) | (carry & (a ^ b));
+        }
+
+        std::array<std::uint8_t, Bitboard::Words * 64> bytes;
+        for (std::size_t first = 0; first < Bitboard::Cells; first += 8) {
+            const std::size_t word = first / 64;
+            const std::size_t shift = first % 64;
+
+            std::uint64_t sum = 0;
+            for (int k = 0; k < kernel::Planes; ++k)
+                sum += Spread[(total[k].words()[word] >> shift) & 0xFF] << k;
+
+            for (std::size_t i = 0; i < 8; ++i)
+                bytes[first + i] = static_cast<std::uint8_t>(sum >> (8 * i));
+        }
+
+        for (std::size_t y = 0; y < BOARD_SIZE; ++y)
+            for (std::size_t x = 0; x < BOARD_SIZE; ++x)
+                out[y][x] = bytes[y * BOARD_SIZE + x];
+    }
+
+    // Срезы из слов SSE2/AVX2: по 4 слова, горизонтальная маска, затем вертикальная
+    Bitboard maskOf(const std::uint64_t* words) noexcept {
+        std::array<std::uint64_t, Bitboard::Words> w{};
+        for (std::size_t i = 0; i < w.size() && i < 2; ++i)
+            w[i] = words[i];
+        return Bitboard::fromWords(w);
+    }
+
+    void expandPlanes(const std::uint64_t* raw, CoverageMap& out) noexcept {
+        Planes planes;
+        for (int k = 0; k < kernel::Planes; ++k)
+            planes[k] = { maskOf(raw + 4 * k), maskOf(raw + 4 * k + 2) };
+        expandPlanes(planes, out);
+    }
+
+} // namespace
+
+// ------------------------------------------------------------
+//  Выбор реализации
+// ------------------------------------------------------------
+KernelIsa bestKernelIsa() noexcept {
+    static const KernelIsa isa = [] {
+#if BATTLESHIP_KERNEL_X86
+        if constexpr (kernel::FitsTwoWords)
+            return cpuHasAvx2() ? KernelIsa::Avx2 : KernelIsa::Sse2;
+#endif
+        return KernelIsa::Scalar;
+    }();
+    return isa;
+}
+
+const char* kernelIsaName(KernelIsa isa) noexcept {
+    switch (isa) {
+    case KernelIsa::Avx2: return "avx2";
+    case KernelIsa::Sse2: return "sse2";
+    default:              return "scalar";
+    }
+}
+
+void computeCoverage(
+    const Bitboard& blocked,
+    const ShipWeights& weights,
+    CoverageMap& out
+) noexcept
+{
+    computeCoverage(bestKernelIsa(), blocked, weights, out);
+}
+
+// ------------------------------------------------------------
+//  Карта покрытия
+// ------------------------------------------------------------
+void computeCoverage(
+    KernelIsa isa,
+    const Bitboard& blocked,
+    const ShipWeights& weights,
+    CoverageMap& out
+) noexcept
+{
+    const Bitboard free = ~blocked;
+
+    // Недоступную реализацию заменяем скалярной
+    if (isa != KernelIsa::Scalar && static_cast<int>(isa) > static_cast<int>(bestKernelIsa()))
+        isa = KernelIsa::Scalar;
+
+#if BATTLESHIP_KERNEL_X86
+    if constexpr (kernel::FitsTwoWords) {
+        const std::uint64_t lo = free.words()[0];
+        const std::uint64_t hi = Bitboard::Words > 1 ? free.words()[Bitboard::Words - 1] : 0;
+
+        if (isa == KernelIsa::Avx2) {
+            const std::uint64_t freeWords[2]{ lo, hi };
+            std::uint64_t planes[4 * kernel::Planes];
+            kernel::coveragePlanesAvx2(freeWords, weights.data(), planes);
+            expandPlanes(planes, out);
+            return;
+        }
+
+        if (isa == KernelIsa::Sse2) {
+            Sse2Ops::Vec planes[kernel::Planes];
+            const __m128i f = words(lo, hi);
+            kernel::coveragePlanes<Sse2Ops>({ f, f }, weights.data(), planes);
+
+            std::uint64_t raw[4 * kernel::Planes];
+            for (int k = 0; k < kernel::Planes; ++k) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + 4 * k), planes[k].horizontal);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + 4 * k + 2), planes[k].vertical);
+            }
+            expandPlanes(raw, out);
+            return;
+        }
+    }
+#endif
+
+    ScalarOps::Vec raw[kernel::Planes];
+    kernel::coveragePlanes<ScalarOps>({ free, free }, weights.data(), raw);
+
+    Planes planes;
+    for (int k = 0; k < kernel::Planes; ++k)
+        planes[k] = { raw[k].horizontal, raw[k].vertical };
+    expandPlanes(planes, out);
+}
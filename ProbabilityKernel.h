@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <array>
+
+#include "Bitboard.h"
+#include "GameConfig.h"
+
+/**
+ * @file ProbabilityKernel.h
+ * @brief Векторное ядро карты покрытия для ProbabilityMap.
+ *
+ * Для каждой различной длины корабля все допустимые положения
+ * находятся сразу: скользящее AND свободных клеток вдоль строк
+ * (горизонтальные) и столбцов (вертикальные). Покрытие клеток
+ * копится в битовых срезах счётчиков, вес длины — число кораблей
+ * этой длины. Реализации: скалярная, SSE2 и AVX2 (выбор по CPU
+ * при первом вызове); результат у всех одинаковый.
+ */
+
+// Число положений кораблей через каждую клетку (с весами)
+using CoverageMap = std::array<std::array<int, BOARD_SIZE>, BOARD_SIZE>;
+
+// Вес каждой длины корабля: weights[len] <= SHIP_COUNTS[len]
+using ShipWeights = ShipCounts;
+
+// Набор инструкций ядра
+enum class KernelIsa {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+/**
+ * @brief Лучший набор инструкций, доступный на этом CPU.
+ */
+[[nodiscard]]
+KernelIsa bestKernelIsa() noexcept;
+
+[[nodiscard]]
+const char* kernelIsaName(KernelIsa isa) noexcept;
+
+/**
+ * @brief Карта покрытия для поля с закрытыми клетками blocked.
+ *
+ * Однопалубный корабль считается и горизонтальным, и вертикальным —
+ * как в исходном пересчёте ProbabilityMap::compute().
+ */
+void computeCoverage(
+    const Bitboard& blocked,
+    const ShipWeights& weights,
+    CoverageMap& out
+) noexcept;
+
+/**
+ * @brief То же с явным выбором реализации (недоступная заменяется скалярной).
+ */
+void computeCoverage(
+    KernelIsa isa,
+    const Bitboard& blocked,
+    const ShipWeights& weights,
+    CoverageMap& out
+) noexcept;
@@ -0,0 +1,76 @@
+﻿#include "ProbabilityKernelImpl.h"
+
+#if BATTLESHIP_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+// ------------------------------------------------------------
+//  AVX2: обе маски в одном 256-битном регистре
+//
+//  64-битные дорожки: [гориз. младшее, гориз. старшее,
+//  верт. младшее, верт. старшее]. Сдвиг на клетку — это сдвиг
+//  на 1 бит для горизонтальной половины и на Width бит для
+//  вертикальной, поэтому используются сдвиги с переменным шагом.
+//
+//  Файл собирается с -mavx2; вызывается только после проверки CPU.
+// ------------------------------------------------------------
+#if BATTLESHIP_KERNEL_X86
+
+namespace {
+
+    struct Avx2Ops {
+        using Vec = __m256i;
+
+        static Vec zero() noexcept { return _mm256_setzero_si256(); }
+        static Vec bitAnd(Vec a, Vec b) noexcept { return _mm256_and_si256(a, b); }
+        static Vec bitXor(Vec a, Vec b) noexcept { return _mm256_xor_si256(a, b); }
+
+        static Vec step() noexcept { return _mm256_set_epi64x(kernel::Width, kernel::Width, 1, 1); }
+        static Vec carryStep() noexcept { return _mm256_set_epi64x(64 - kernel::Width, 64 - kernel::Width, 63, 63); }
+
+        static Vec lanes(std::uint64_t hLo, std::uint64_t hHi, std::uint64_t vLo, std::uint64_t vHi) noexcept {
+            return _mm256_set_epi64x(
+                static_cast<long long>(vHi), static_cast<long long>(vLo),
+                static_cast<long long>(hHi), static_cast<long long>(hLo));
+        }
+
+        // x - 1 / y - 1: первый столбец уходит за край
+        static Vec back(Vec a) noexcept {
+            a = _mm256_and_si256(a, lanes(kernel::NoFirstLo, kernel::NoFirstHi, ~std::uint64_t{ 0 }, ~std::uint64_t{ 0 }));
+            const Vec low = _mm256_srlv_epi64(a, step());
+            const Vec high = _mm256_sllv_epi64(_mm256_srli_si256(a, 8), carryStep());
+            return _mm256_or_si256(low, high);
+        }
+
+        // x + 1 / y + 1: последний столбец и биты за полем уходят за край
+        static Vec forward(Vec a) noexcept {
+            a = _mm256_and_si256(a, lanes(kernel::NoLastLo, kernel::NoLastHi, ~std::uint64_t{ 0 }, ~std::uint64_t{ 0 }));
+            const Vec low = _mm256_sllv_epi64(a, step());
+            const Vec high = _mm256_srlv_epi64(_mm256_slli_si256(a, 8), carryStep());
+            return _mm256_and_si256(
+                _mm256_or_si256(low, high),
+                lanes(kernel::BoardLo, kernel::BoardHi, kernel::BoardLo, kernel::BoardHi));
+        }
+    };
+
+} // namespace
+
+void kernel::coveragePlanesAvx2(
+    const std::uint64_t* free,
+    const int* weights,
+    std::uint64_t* planes
+) noexcept
+{
+    Avx2Ops::Vec out[Planes];
+    coveragePlanes<Avx2Ops>(Avx2Ops::lanes(free[0], free[1], free[0], free[1]), weights, out);
+
+    for (int k = 0; k < Planes; ++k)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(planes + 4 * k), out[k]);
+}
+
+#else
+
+void kernel::coveragePlanesAvx2(const std::uint64_t*, const int*, std::uint64_t*) noexcept {
+}
+
+#endif
@@ -0,0 +1,149 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GameConfig.h"
+
+/**
+ * @file ProbabilityKernelImpl.h
+ * @brief Общая часть реализаций ядра карты покрытия.
+ *
+ * Подключается и из ProbabilityKernelAvx2.cpp, который собирается
+ * с флагами AVX2, поэтому здесь только шаблоны и константы — никаких
+ * общих inline-функций (иначе компоновщик мог бы взять их
+ * AVX2-версию для кода, работающего на любом CPU).
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATTLESHIP_KERNEL_X86 1
+#else
+#define BATTLESHIP_KERNEL_X86 0
+#endif
+
+namespace kernel {
+
+    constexpr int Width = static_cast<int>(BOARD_SIZE);
+    constexpr int Cells = Width * Width;
+
+    // Векторные версии работают с полем в двух 64-битных словах
+    constexpr bool FitsTwoWords = Cells <= 128;
+
+    // Наибольшее покрытие клетки: каждый корабль проходит через неё
+    // не более чем len горизонтальными и len вертикальными положениями
+    constexpr int MaxCoverage = [] {
+        int sum = 0;
+        for (int len : SHIP_SIZES)
+            sum += 2 * len;
+        return sum;
+    }();
+
+    // Число битовых срезов счётчика
+    constexpr int Planes = [] {
+        int planes = 0;
+        while ((1 << planes) <= MaxCoverage)
+            ++planes;
+        return planes;
+    }();
+
+    // Слова масок для полей из двух слов: клетки поля, без первого
+    // и без последнего столбца
+    consteval std::uint64_t wordOf(int word, bool skipFirst, bool skipLast) {
+        std::uint64_t w = 0;
+        for (int i = 0; i < Cells; ++i) {
+            const int x = i % Width;
+            if ((skipFirst && x == 0) || (skipLast && x == Width - 1))
+                continue;
+            if (i / 64 == word)
+                w |= std::uint64_t{ 1 } << (i % 64);
+        }
+        return w;
+    }
+
+    constexpr std::uint64_t BoardLo = wordOf(0, false, false);
+    constexpr std::uint64_t BoardHi = wordOf(1, false, false);
+    constexpr std::uint64_t NoFirstLo = wordOf(0, true, false);
+    constexpr std::uint64_t NoFirstHi = wordOf(1, true, false);
+    constexpr std::uint64_t NoLastLo = wordOf(0, false, true);
+    constexpr std::uint64_t NoLastHi = wordOf(1, false, true);
+
+    /**
+     * Прибавляет к битовым срезам planes маску cover с весом weight.
+     */
+    template <class Ops>
+    inline void addWeighted(
+        typename Ops::Vec* planes,
+        typename Ops::Vec cover,
+        int weight
+    ) noexcept
+    {
+        for (int bit = 0; (weight >> bit) != 0; ++bit) {
+            if (((weight >> bit) & 1) == 0)
+                continue;
+
+            typename Ops::Vec carry = cover;
+            for (int k = bit; k < Planes; ++k) {
+                const typename Ops::Vec next = Ops::bitAnd(planes[k], carry);
+                planes[k] = Ops::bitXor(planes[k], carry);
+                carry = next;
+            }
+        }
+    }
+
+    /**
+     * Битовые срезы покрытия.
+     *
+     * Ops::Vec несёт две маски сразу — горизонтальную и вертикальную:
+     * Ops::back() сдвигает их на клетку назад (x - 1 и y - 1),
+     * Ops::forward() — вперёд (x + 1 и y + 1).
+     *
+     * @param free     свободные клетки (в обеих половинах)
+     * @param weights  вес каждой длины, weights[len]
+     * @param planes   Planes срезов
+     */
+    template <class Ops>
+    inline void coveragePlanes(
+        typename Ops::Vec free,
+        const int* weights,
+        typename Ops::Vec* planes
+    ) noexcept
+    {
+        for (int k = 0; k < Planes; ++k)
+            planes[k] = Ops::zero();
+
+        // starts — начала положений длины len: клетки, у которых
+        // свободны и они сами, и len - 1 следующих по направлению
+        typename Ops::Vec shifted = free;
+        typename Ops::Vec starts = free;
+
+        for (int len = 1; len <= MAX_SHIP_LENGTH; ++len) {
+            if (len > 1) {
+                shifted = Ops::back(shifted);
+                starts = Ops::bitAnd(starts, shifted);
+            }
+
+            if (weights[len] == 0)
+                continue;
+
+            typename Ops::Vec cover = starts;
+            for (int i = 0; i < len; ++i) {
+                if (i > 0)
+                    cover = Ops::forward(cover);
+                addWeighted<Ops>(planes, cover, weights[len]);
+            }
+        }
+    }
+
+    /**
+     * AVX2-реализация (ProbabilityKernelAvx2.cpp).
+     *
+     * @param free    два слова свободных клеток
+     * @param planes  Planes срезов по 4 слова: горизонтальные, затем вертикальные
+     */
+    void coveragePlanesAvx2(
+        const std::uint64_t* free,
+        const int* weights,
+        std::uint64_t* planes
+    ) noexcept;
+
+} // namespace kernel
@@ -1,74 +1,256 @@
 #include "ProbabilityMap.h"
+#include "ProbabilityKernel.h"
+#include "Profiler.h"
+#include "ShipPlacements.h"
 
 // ------------------------------------------------------------
-//    
+//      
+//
+//      Rules::ShipSizes   
+// (  ;   ,
+//    compute()).       
+//   ,        compute().
+//    shipPlacementTable;    .
 // ------------------------------------------------------------
-bool ProbabilityMap::canPlace(
-    const Board& board,
-    const ShotsGrid& shots,
-    int x, int y,
-    int length,
-    bool horizontal
-) const noexcept
-{
-    const int dx = horizontal ? 1 : 0;
-    const int dy = horizontal ? 0 : 1;
+namespace {
 
-    for (int i = 0; i < length; ++i) {
-        const int cx = x + dx * i;
-        const int cy = y + dy * i;
+    template <class Rules>
+    struct Placement {
+        std::int16_t shape = 0;    //   shipPlacementTable<Rules>.all
+        std::int16_t length = 0;
 
-        if (!board.isInside(cx, cy))
-            return false;
+        [[nodiscard]]
+        constexpr const typename Rules::Bitboard& body() const noexcept {
+            return shipPlacementTable<Rules>.all[static_cast<std::size_t>(shape)].body;
+        }
+    };
 
-        const auto cell = board.cells()[cy][cx];
+    //       
+    template <class Rules>
+    constexpr std::size_t MaxThrough = [] {
+        std::size_t count = 0;
+        for (int len = 1; len <= Rules::MaxShipLength; ++len)
+            if (Rules::ShipCounts[len])
+                count += 2 * static_cast<std::size_t>(len);
+        return count;
+    }();
 
-        //    
-        if (cell == CellState::Miss)
-            return false;
+    template <class Rules>
+    struct PlacementTable {
+        static constexpr std::size_t N = Rules::BoardSize;
 
-        //           
-        if (cell == CellState::Sunk)
-            return false;
+        std::array<Placement<Rules>, PlacementCount<Rules>> all{};
+        std::array<std::size_t, Rules::MaxShipLength + 2> firstOfLength{};   // all   
+        std::array<std::array<std::int16_t, MaxThrough<Rules>>, Rules::Cells> through{};   //   
+        std::array<std::uint8_t, Rules::Cells> throughCount{};
+        std::array<std::array<int, N>, N> emptyMap{};
+    };
 
-        // Ship  !
-        //   ,   .
-        // Hit    ,      .
-    }
+    template <class Rules>
+    constexpr PlacementTable<Rules> Placements = [] {
+        constexpr std::size_t n = Rules::BoardSize;
+        PlacementTable<Rules> t;
+        std::size_t next = 0;
+
+        for (int len = 1; len <= Rules::MaxShipLength; ++len) {
+            t.firstOfLength[len] = next;
+            const int weight = Rules::ShipCounts[len];
+            if (weight == 0)
+                continue;
+
+            // at[]        ,  
+            // shipPlacementTable;     
+            for (std::int16_t shape : shipPlacementTable<Rules>.at[len]) {
+                if (shape == BasicShipPlacementTable<Rules>::None)
+                    continue;
+
+                const std::size_t id = next++;
+                t.all[id] = Placement<Rules>{ shape, static_cast<std::int16_t>(len) };
+                t.all[id].body().forEach([&](std::size_t index) {
+                    t.through[index][t.throughCount[index]++] = static_cast<std::int16_t>(id);
+                    t.emptyMap[index / n][index % n] += weight;
+                    });
+            }
+        }
+        t.firstOfLength[Rules::MaxShipLength + 1] = next;
+        return t;
+    }();
+
+    //      (std::bitset  constexpr 
+    //     )
+    template <class Rules>
+    const std::array<std::bitset<PlacementCount<Rules>>, Rules::MaxShipLength + 1> LengthMasks = [] {
+        const PlacementTable<Rules>& table = Placements<Rules>;
+        std::array<std::bitset<PlacementCount<Rules>>, Rules::MaxShipLength + 1> masks{};
+        for (int len = 1; len <= Rules::MaxShipLength; ++len)
+            for (std::size_t id = table.firstOfLength[len]; id < table.firstOfLength[len + 1]; ++id)
+                masks[len].set(id);
+        return masks;
+    }();
+
+} // namespace
 
-    return true;
+// ------------------------------------------------------------
+// :   
+// ------------------------------------------------------------
+template <class Rules>
+BasicProbabilityMap<Rules>::BasicProbabilityMap() noexcept {
+    reset();
+}
+
+template <class Rules>
+void BasicProbabilityMap<Rules>::reset() noexcept {
+    const PlacementTable<Rules>& table = Placements<Rules>;
+
+    map = table.emptyMap;
+    blocked_ = {};
+    weights_ = Rules::ShipCounts;
+    valid_.set();
+    live_ = table.all.size();
 }
 
 // ------------------------------------------------------------
 //   
+//
+// Miss, Sunk  closed  ; Ship   ,  
+// Hit    .     ProbabilityKernel.
 // ------------------------------------------------------------
-void ProbabilityMap::compute(
+template <class Rules>
+void BasicProbabilityMap<Rules>::compute(
     const Board& board,
-    const ShotsGrid& shots
+    [[maybe_unused]] const ShotsGrid& shots,
+    const Bitboard& closed,
+    const Weights& weights
 ) noexcept
 {
-    //  
-    for (auto& row : map)
-        row.fill(0);
-
-    //    
-    for (int len : SHIP_SIZES) {
-
-        for (int y = 0; y < static_cast<int>(BOARD_SIZE); ++y) {
-            for (int x = 0; x < static_cast<int>(BOARD_SIZE); ++x) {
-
-                // 
-                if (canPlace(board, shots, x, y, len, true)) {
-                    for (int i = 0; i < len; ++i)
-                        map[y][x + i]++;
-                }
-
-                // 
-                if (canPlace(board, shots, x, y, len, false)) {
-                    for (int i = 0; i < len; ++i)
-                        map[y + i][x]++;
-                }
+    ProfileScope profile(ProfileZone::MapCompute);
+
+    const Bitboard blocked = board.misses() | board.sunk() | closed;
+    if constexpr (IsClassicRules<Rules>)
+        computeCoverage(blocked, weights, map);
+    else
+        map = {};
+    ++updates_;
+
+    //    update():   
+    //  ,     .  
+    //  ,    .
+    const PlacementTable<Rules>& table = Placements<Rules>;
+    blocked_ = blocked;
+    weights_ = weights;
+    valid_.reset();
+    for (int len = 1; len <= Rules::MaxShipLength; ++len)
+        if (weights_[len] > 0)
+            valid_ |= LengthMasks<Rules>[len];
+
+    blocked_.forEach([&](std::size_t index) {
+        for (std::size_t k = 0; k < table.throughCount[index]; ++k)
+            valid_.reset(static_cast<std::size_t>(table.through[index][k]));
+        });
+    live_ = valid_.count();
+
+    //         
+    //    
+    if constexpr (!IsClassicRules<Rules>) {
+        for (std::size_t id = 0; id < table.all.size(); ++id) {
+            if (!valid_[id])
+                continue;
+
+            const Placement<Rules>& p = table.all[id];
+            const int weight = weights_[p.length];
+            p.body().forEach([&](std::size_t cell) {
+                map[cell / Rules::BoardSize][cell % Rules::BoardSize] += weight;
+                });
+        }
+    }
+}
+
+// ------------------------------------------------------------
+//   
+//
+//          
+// (      ).   
+//      ,   
+//     .
+// ------------------------------------------------------------
+template <class Rules>
+void BasicProbabilityMap<Rules>::update(const Board& board, const Bitboard& closed, const Weights& weights) noexcept
+{
+    ProfileScope profile(ProfileZone::MapUpdate);
+
+    const Bitboard blocked = board.misses() | board.sunk() | closed;
+
+    //    ,    
+    // ,   
+    bool grown = (blocked_ & ~blocked).any();
+    for (int len = 1; len <= Rules::MaxShipLength; ++len)
+        grown |= weights[len] > weights_[len];
+    if (grown)
+        reset();
+    ++updates_;
+
+    const PlacementTable<Rules>& table = Placements<Rules>;
+
+    auto subtract = [&](const Placement<Rules>& p, int weight) {
+        p.body().forEach([&](std::size_t cell) {
+            map[cell / Rules::BoardSize][cell % Rules::BoardSize] -= weight;
+            });
+    };
+
+    for (int len = 1; len <= Rules::MaxShipLength; ++len) {
+        const int sunk = weights_[len] - weights[len];
+        if (sunk == 0)
+            continue;
+
+        for (std::size_t id = table.firstOfLength[len]; id < table.firstOfLength[len + 1]; ++id) {
+            if (!valid_[id])
+                continue;
+
+            subtract(table.all[id], sunk);
+            if (weights[len] == 0) {
+                valid_[id] = false;
+                --live_;
             }
         }
+        weights_[len] = weights[len];
     }
+
+    const Bitboard fresh = blocked & ~blocked_;
+    blocked_ = blocked;
+
+    fresh.forEach([&](std::size_t index) {
+        for (std::size_t k = 0; k < table.throughCount[index]; ++k) {
+            const int id = table.through[index][k];
+            if (!valid_[id])
+                continue;
+            valid_[id] = false;
+            --live_;
+
+            const Placement<Rules>& p = table.all[id];
+            subtract(p, weights_[p.length]);
+        }
+        });
 }
+
+// ------------------------------------------------------------
+//    
+// ------------------------------------------------------------
+template <class Rules>
+bool BasicProbabilityMap<Rules>::matchesFullRecompute(
+    const Board& board,
+    const ShotsGrid& shots,
+    const Bitboard& closed,
+    const Weights& weights
+) const noexcept
+{
+    BasicProbabilityMap reference;
+    reference.compute(board, shots, closed, weights);
+    return reference.map == map;
+}
+
+// ------------------------------------------------------------
+//    
+// ------------------------------------------------------------
+#define RULES_INSTANTIATE(Rules, name) template class BasicProbabilityMap<Rules>;
+RULES_VARIANTS(RULES_INSTANTIATE)
+#undef RULES_INSTANTIATE
@@ -1,43 +1,130 @@
 ﻿#pragma once
 
+#include <algorithm>
 #include <array>
+#include <bitset>
+#include <cstdint>
+#include "Bitboard.h"
 #include "Board.h"
 #include "ShotsGrid.h"
 #include "GameConfig.h"
+#include "GameRules.h"
+#include "ProbabilityKernel.h"
+
+// Число положений кораблей: для каждой различной длины из Rules::ShipSizes
+// все горизонтальные и все вертикальные
+template <class Rules>
+inline constexpr std::size_t PlacementCount = [] {
+    constexpr std::size_t n = Rules::BoardSize;
+    std::size_t count = 0;
+    for (int len = 1; len <= Rules::MaxShipLength; ++len)
+        if (Rules::ShipCounts[len])
+            count += 2 * n * (n - static_cast<std::size_t>(len) + 1);
+    return count;
+}();
+
+inline constexpr std::size_t PLACEMENT_COUNT = PlacementCount<ClassicRules>;
 
 /**
- * ProbabilityMap
+ * BasicProbabilityMap
  *
  * Строит карту вероятностей для выбора следующего выстрела ИИ.
  * Учитывает:
  *  - промахи (Miss)
  *  - попадания (Hit)
  *  - затопленные корабли (Sunk)
- *  - размеры оставшихся кораблей
+ *  - размеры оставшихся кораблей (weights: сколько кораблей каждой
+ *    длины ещё не затоплено; затопленные длины не считаются вовсе)
+ *  - клетки, закрытые выводом (closed, см. ConstraintPropagation.h)
+ *
+ * Карта хранит состояние между ходами: для каждого положения корабля
+ * помнится, возможно ли оно ещё. Новый промах или затопление закрывает
+ * клетки, и update() вычитает из карты только положения через них.
+ *
+ * Полный пересчёт для ClassicRules — векторное ядро ProbabilityKernel,
+ * для остальных правил — перебор таблицы положений.
  */
-class ProbabilityMap {
+template <class Rules>
+class BasicProbabilityMap {
 public:
+    using Bitboard = typename Rules::Bitboard;
+    using Board = BasicBoard<Rules>;
+    using ShotsGrid = BasicShotsGrid<Rules::BoardSize>;
+    using Weights = typename Rules::Counts;
+
     // Карта вероятностей
-    std::array<std::array<int, BOARD_SIZE>, BOARD_SIZE> map{};
+    std::array<std::array<int, Rules::BoardSize>, Rules::BoardSize> map{};
+
+    BasicProbabilityMap() noexcept;
 
     /**
-     * Пересчитывает карту вероятностей.
+     * Пересчитывает карту вероятностей с нуля.
+     *
+     * @param closed   клетки, где корабля заведомо нет, сверх Miss и Sunk
+     * @param weights  оставшиеся корабли каждой длины
      */
     void compute(
         const Board& board,
-        const ShotsGrid& shots
+        const ShotsGrid& shots,
+        const Bitboard& closed = {},
+        const Weights& weights = Rules::ShipCounts
+    ) noexcept;
+
+    /**
+     * Обновляет карту по клеткам, закрытым с прошлого вызова,
+     * и по кораблям, затопленным с прошлого вызова.
+     * Если поле сменилось (закрытые клетки пропали или корабли
+     * «всплыли») — начинает заново.
+     */
+    void update(
+        const Board& board,
+        const Bitboard& closed = {},
+        const Weights& weights = Rules::ShipCounts
     ) noexcept;
 
-private:
     /**
-     * Проверяет, можно ли разместить корабль длины length
-     * начиная с (x, y) в направлении horizontal.
+     * Сверяет текущую карту с полным пересчётом compute().
      */
-    bool canPlace(
+    [[nodiscard]]
+    bool matchesFullRecompute(
         const Board& board,
         const ShotsGrid& shots,
-        int x, int y,
-        int length,
-        bool horizontal
+        const Bitboard& closed = {},
+        const Weights& weights = Rules::ShipCounts
     ) const noexcept;
+
+    /**
+     * Положения, ещё входящие в карту (не закрыты и длина не затоплена целиком).
+     */
+    [[nodiscard]]
+    std::size_t livePlacements() const noexcept { return live_; }
+
+    /**
+     * Число вызовов compute() и update() (по нему видно, был ли ход по карте).
+     */
+    [[nodiscard]]
+    std::uint64_t updates() const noexcept { return updates_; }
+
+private:
+    // Клетки Miss, Sunk и closed, уже учтённые в карте
+    Bitboard blocked_;
+
+    // Корабли каждой длины, уже учтённые в карте
+    Weights weights_{};
+
+    // Возможно ли ещё каждое положение корабля (см. ProbabilityMap.cpp)
+    std::bitset<PlacementCount<Rules>> valid_;
+    std::size_t live_ = 0;   ///< число установленных битов valid_
+    std::uint64_t updates_ = 0;
+
+    /**
+     * Карта и состояние для пустого поля.
+     */
+    void reset() noexcept;
 };
+
+#define RULES_EXTERN(Rules, name) extern template class BasicProbabilityMap<Rules>;
+RULES_VARIANTS(RULES_EXTERN)
+#undef RULES_EXTERN
+
+using ProbabilityMap = BasicProbabilityMap<ClassicRules>;
@@ -0,0 +1,222 @@
+﻿#include "Profiler.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t ZoneCount = static_cast<std::size_t>(ProfileZone::Count);
+    constexpr std::size_t CounterCount = static_cast<std::size_t>(ProfileCounter::Count);
+
+    // Событие трассы: участок zone потока thread
+    struct TraceEvent {
+        std::uint64_t start;
+        std::uint64_t duration;
+        std::uint32_t thread;
+        ProfileZone zone;
+    };
+
+    struct ProfilerState {
+        std::mutex mutex;
+        std::array<LogHistogram, ZoneCount> zones{};
+        std::vector<TraceEvent> trace;
+        const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    };
+
+    ProfilerState& state() {
+        static ProfilerState s;
+        return s;
+    }
+
+    // Номер потока для трассы: по порядку первого замера
+    std::uint32_t threadIndex() noexcept {
+        static std::atomic<std::uint32_t> next{ 0 };
+        thread_local const std::uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    double micros(std::uint64_t ns) noexcept {
+        return static_cast<double>(ns) / 1000.0;
+    }
+
+} // namespace
+
+// ------------------------------------------------------------
+//  Включение и сброс
+// ------------------------------------------------------------
+void Profiler::setEnabled(bool on)
+{
+    if (on) {
+        ProfilerState& s = state();
+        std::lock_guard lock(s.mutex);
+        s.trace.reserve(MaxTraceEvents);
+    }
+    enabled_.store(on, std::memory_order_relaxed);
+}
+
+void Profiler::reset() noexcept
+{
+    ProfilerState& s = state();
+    std::lock_guard lock(s.mutex);
+    s.zones.fill(LogHistogram{});
+    s.trace.clear();
+    for (auto& c : counters_)
+        c.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t Profiler::now() noexcept
+{
+    const auto elapsed = std::chrono::steady_clock::now() - state().origin;
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+// ------------------------------------------------------------
+//  Запись участка
+// ------------------------------------------------------------
+void Profiler::record(ProfileZone zone, std::uint64_t startNs, std::uint64_t durationNs) noexcept
+{
+    if (!enabled())
+        return;
+
+    const std::uint32_t thread = threadIndex();
+    ProfilerState& s = state();
+    std::lock_guard lock(s.mutex);
+
+    s.zones[static_cast<std::size_t>(zone)].add(durationNs);
+    if (s.trace.size() < s.trace.capacity())
+        s.trace.push_back({ startNs, durationNs, thread, zone });
+}
+
+LogHistogram Profiler::histogram(ProfileZone zone) noexcept
+{
+    ProfilerState& s = state();
+    std::lock_guard lock(s.mutex);
+    return s.zones[static_cast<std::size_t>(zone)];
+}
+
+// ------------------------------------------------------------
+//  Имена
+// ------------------------------------------------------------
+const char* Profiler::zoneName(ProfileZone zone) noexcept
+{
+    switch (zone) {
+    case ProfileZone::Frame:      return "frame";
+    case ProfileZone::Draw:       return "draw";
+    case ProfileZone::AiThink:    return "ai_think";
+    case ProfileZone::MapCompute: return "map_compute";
+    case ProfileZone::MapUpdate:  return "map_update";
+    default:                      return "?";
+    }
+}
+
+const char* Profiler::counterName(ProfileCounter counter) noexcept
+{
+    switch (counter) {
+    case ProfileCounter::Frames:    return "frames";
+    case ProfileCounter::DrawCalls: return "draw_calls";
+    case ProfileCounter::AiShots:   return "ai_shots";
+    default:                        return "?";
+    }
+}
+
+// ------------------------------------------------------------
+//  Сводка
+// ------------------------------------------------------------
+std::string Profiler::summary()
+{
+    std::array<LogHistogram, ZoneCount> zones;
+    {
+        ProfilerState& s = state();
+        std::lock_guard lock(s.mutex);
+        zones = s.zones;
+    }
+
+    std::string text;
+    char line[160];
+
+    // Заголовок выровнен вручную: %-12s считает байты, а не буквы
+    text += "участок, мкс     число     средн       p50       p99      макс\n";
+    for (std::size_t z = 0; z < ZoneCount; ++z) {
+        const LogHistogram& h = zones[z];
+        std::snprintf(line, sizeof(line), "%-12s %9llu %9.1f %9.1f %9.1f %9.1f\n",
+            zoneName(static_cast<ProfileZone>(z)),
+            static_cast<unsigned long long>(h.count()),
+            h.mean() / 1000.0,
+            micros(h.percentile(0.5)),
+            micros(h.percentile(0.99)),
+            micros(h.max()));
+        text += line;
+    }
+
+    for (std::size_t c = 0; c < CounterCount; ++c) {
+        std::snprintf(line, sizeof(line), "%-12s %9llu\n",
+            counterName(static_cast<ProfileCounter>(c)),
+            static_cast<unsigned long long>(counter(static_cast<ProfileCounter>(c))));
+        text += line;
+    }
+    return text;
+}
+
+// ------------------------------------------------------------
+//  Трасса Chrome (участки — события "X", счётчики — "C" в конце)
+// ------------------------------------------------------------
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+    std::vector<TraceEvent> trace;
+    {
+        ProfilerState& s = state();
+        std::lock_guard lock(s.mutex);
+        trace = s.trace;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+
+    std::uint64_t end = 0;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char line[200];
+    for (const TraceEvent& e : trace) {
+        std::snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+            zoneName(e.zone), e.thread, micros(e.start), micros(e.duration));
+        out << line;
+        if (e.start + e.duration > end)
+            end = e.start + e.duration;
+    }
+
+    std::snprintf(line, sizeof(line), "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":%.3f,\"args\":{", micros(end));
+    out << line;
+    for (std::size_t c = 0; c < CounterCount; ++c) {
+        out << (c ? "," : "") << '"' << counterName(static_cast<ProfileCounter>(c)) << "\":"
+            << counter(static_cast<ProfileCounter>(c));
+    }
+    out << "}}\n]}\n";
+
+    return static_cast<bool>(out);
+}
+
+// ------------------------------------------------------------
+//  Переменная окружения
+// ------------------------------------------------------------
+std::string Profiler::tracePathFromEnvironment()
+{
+#ifdef _MSC_VER
+    // getenv в MSVC помечен небезопасным (SDL-проверки)
+    char* value = nullptr;
+    std::size_t length = 0;
+    if (_dupenv_s(&value, &length, "BATTLESHIP_PROFILE") != 0 || !value)
+        return {};
+    std::string path(value);
+    std::free(value);
+    return path;
+#else
+    const char* value = std::getenv("BATTLESHIP_PROFILE");
+    return value ? std::string(value) : std::string{};
+#endif
+}
@@ -0,0 +1,139 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "Histogram.h"
+
+/**
+ * @file Profiler.h
+ * @brief Замеры времени кадра и ИИ: зоны, счётчики, трасса.
+ *
+ * Всегда собирается в программу, но включается во время работы
+ * (Profiler::setEnabled, в игре — F3 или переменная окружения
+ * BATTLESHIP_PROFILE). Выключенный замер — одна проверка флага.
+ * Включённый пишет длительность в гистограмму зоны и событие
+ * в трассу, которую можно выгрузить в формате Chrome trace
+ * (chrome://tracing, Perfetto). Запись без выделения памяти:
+ * буфер трассы резервируется при включении.
+ */
+
+// Замеряемые участки
+enum class ProfileZone : std::uint8_t {
+    Frame,          ///< обработка кадра в Game::run (без ожидания событий)
+    Draw,           ///< Renderer::draw
+    AiThink,        ///< выбор выстрела ИИ (AIController::chooseShot)
+    MapCompute,     ///< полный пересчёт ProbabilityMap
+    MapUpdate,      ///< пересчёт ProbabilityMap по изменению
+    Count
+};
+
+// Счётчики событий
+enum class ProfileCounter : std::uint8_t {
+    Frames,         ///< нарисованные кадры
+    DrawCalls,      ///< вызовы draw окна
+    AiShots,        ///< выстрелы ИИ
+    Count
+};
+
+/**
+ * @class Profiler
+ * @brief Общие для программы зоны, счётчики и трасса (потокобезопасно).
+ */
+class Profiler {
+public:
+    // Больше событий в трассе не пишется (гистограммы копятся дальше)
+    static constexpr std::size_t MaxTraceEvents = std::size_t{ 1 } << 19;
+
+    [[nodiscard]]
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Включает или выключает замеры. При первом включении
+     *        резервирует буфер трассы.
+     */
+    static void setEnabled(bool on);
+
+    // Сбрасывает гистограммы, счётчики и трассу
+    static void reset() noexcept;
+
+    // Наносекунды от запуска программы
+    [[nodiscard]]
+    static std::uint64_t now() noexcept;
+
+    // Записывает участок zone, начатый в startNs (только если замеры включены)
+    static void record(ProfileZone zone, std::uint64_t startNs, std::uint64_t durationNs) noexcept;
+
+    static void count(ProfileCounter counter, std::uint64_t n = 1) noexcept {
+        if (enabled())
+            counters_[static_cast<std::size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]]
+    static LogHistogram histogram(ProfileZone zone) noexcept;
+
+    [[nodiscard]]
+    static std::uint64_t counter(ProfileCounter counter) noexcept {
+        return counters_[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]]
+    static const char* zoneName(ProfileZone zone) noexcept;
+
+    [[nodiscard]]
+    static const char* counterName(ProfileCounter counter) noexcept;
+
+    /**
+     * @brief Сводка по зонам (число, среднее, p50, p99, максимум в мкс)
+     *        и счётчикам — по строке на зону или счётчик.
+     */
+    [[nodiscard]]
+    static std::string summary();
+
+    /**
+     * @brief Выгружает трассу в формате Chrome trace JSON.
+     * @return false — файл не удалось записать
+     */
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * @brief Путь трассы из переменной окружения BATTLESHIP_PROFILE
+     *        (пустая строка — переменная не задана).
+     */
+    [[nodiscard]]
+    static std::string tracePathFromEnvironment();
+
+private:
+    static inline std::atomic<bool> enabled_{ false };
+    static inline std::atomic<std::uint64_t> counters_[static_cast<std::size_t>(ProfileCounter::Count)]{};
+};
+
+/**
+ * @class ProfileScope
+ * @brief Замер участка от конструктора до деструктора.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone zone) noexcept
+        : zone_(zone)
+        , start_(Profiler::enabled() ? Profiler::now() : Off)
+    {
+    }
+
+    ~ProfileScope() {
+        if (start_ != Off)
+            Profiler::record(zone_, start_, Profiler::now() - start_);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    static constexpr std::uint64_t Off = std::numeric_limits<std::uint64_t>::max();
+
+    ProfileZone zone_;
+    std::uint64_t start_;
+};
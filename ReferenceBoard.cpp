@@ -0,0 +1,126 @@
+﻿#include "ReferenceBoard.h"
+
+#include <array>
+#include <utility>
+
+// ------------------------------------------------------------
+//  Конструктор
+// ------------------------------------------------------------
+ReferenceBoard::ReferenceBoard(const BoardGrid& cells) noexcept {
+    for (int y = 0; y < static_cast<int>(BOARD_SIZE); ++y) {
+        for (int x = 0; x < static_cast<int>(BOARD_SIZE); ++x) {
+            if (cells[y][x] == CellState::Ship) {
+                cells_[y][x] = CellState::Ship;
+                ++shipsCellsTotal_;
+            }
+            else {
+                cells_[y][x] = CellState::Empty;
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+//  Проверка выхода за границы
+// ------------------------------------------------------------
+bool ReferenceBoard::isInside(int x, int y) const noexcept {
+    return x >= 0 && x < static_cast<int>(BOARD_SIZE) &&
+        y >= 0 && y < static_cast<int>(BOARD_SIZE);
+}
+
+// ------------------------------------------------------------
+//  Проверка, затоплен ли корабль, к которому относится (x, y)
+//  Предполагается, что (x, y) - Hit либо только что Hit.
+// ------------------------------------------------------------
+bool ReferenceBoard::isShipSunk(int x, int y) const noexcept {
+    constexpr std::array<std::pair<int, int>, 4> dirs{
+        std::pair{ 1, 0 },
+        std::pair{-1, 0 },
+        std::pair{ 0, 1 },
+        std::pair{ 0,-1 }
+    };
+
+    for (auto [dx, dy] : dirs) {
+        int nx = x;
+        int ny = y;
+
+        while (isInside(nx, ny)) {
+            const auto st = cells_[ny][nx];
+
+            if (st == CellState::Ship)
+                return false;  // есть живая палуба
+
+            if (st != CellState::Hit)
+                break;         // вышли за пределы корабля
+
+            nx += dx;
+            ny += dy;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+//  Пометить корабль как затопленный (все его палубы)
+//  Предполагается, что isShipSunk(x, y) == true.
+// ------------------------------------------------------------
+void ReferenceBoard::markShipSunk(int x, int y) noexcept {
+    constexpr std::array<std::pair<int, int>, 4> dirs{
+        std::pair{ 1, 0 },
+        std::pair{-1, 0 },
+        std::pair{ 0, 1 },
+        std::pair{ 0,-1 }
+    };
+
+    cells_[y][x] = CellState::Sunk;
+
+    for (auto [dx, dy] : dirs) {
+        int nx = x + dx;
+        int ny = y + dy;
+
+        while (isInside(nx, ny) && cells_[ny][nx] == CellState::Hit) {
+            cells_[ny][nx] = CellState::Sunk;
+            nx += dx;
+            ny += dy;
+        }
+    }
+}
+
+// ------------------------------------------------------------
+//  Выстрел по клетке
+// ------------------------------------------------------------
+ShotResult ReferenceBoard::shoot(int x, int y) noexcept {
+    if (!isInside(x, y))
+        return ShotResult::Invalid;
+
+    auto& cell = cells_[y][x];
+
+    // Повторный выстрел
+    if (isShot(cell))
+        return ShotResult::Repeat;
+
+    // Попадание
+    if (cell == CellState::Ship) {
+        cell = CellState::Hit;
+        ++shipsCellsHit_;
+
+        if (isShipSunk(x, y)) {
+            markShipSunk(x, y);
+            return ShotResult::Sunk;
+        }
+
+        return ShotResult::Hit;
+    }
+
+    // Промах
+    cell = CellState::Miss;
+    return ShotResult::Miss;
+}
+
+// ------------------------------------------------------------
+//  Проверка уничтожения всего флота
+// ------------------------------------------------------------
+bool ReferenceBoard::allShipsDestroyed() const noexcept {
+    return shipsCellsTotal_ > 0 &&
+        shipsCellsHit_ == shipsCellsTotal_;
+}
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "Board.h"
+#include "CellState.h"
+#include "GameConfig.h"
+#include "ShotResult.h"
+
+/**
+ * @class ReferenceBoard
+ * @brief Исходное поле на сетке клеток — эталон для сверки с Board.
+ *
+ * shoot(), isShipSunk() и markShipSunk() — первоначальная реализация
+ * (обход сетки от клетки попадания), оставленная без оптимизаций:
+ * battleship_diff прогоняет через неё и через Board одни и те же
+ * выстрелы. Только классические правила.
+ */
+class ReferenceBoard {
+public:
+    /**
+     * @brief Поле с кораблями в клетках Ship сетки cells
+     *        (остальные состояния считаются пустыми).
+     */
+    explicit ReferenceBoard(const BoardGrid& cells) noexcept;
+
+    [[nodiscard]]
+    bool isInside(int x, int y) const noexcept;
+
+    [[nodiscard]]
+    ShotResult shoot(int x, int y) noexcept;
+
+    [[nodiscard]]
+    bool allShipsDestroyed() const noexcept;
+
+    [[nodiscard]]
+    const BoardGrid& cells() const noexcept { return cells_; }
+
+private:
+    BoardGrid cells_{};
+    int shipsCellsTotal_ = 0;
+    int shipsCellsHit_ = 0;
+
+    /**
+     * @brief Затоплен ли корабль, к которому относится (x, y).
+     *
+     * Предполагается, что (x, y) — Hit.
+     */
+    [[nodiscard]]
+    bool isShipSunk(int x, int y) const noexcept;
+
+    /**
+     * @brief Помечает все палубы корабля как Sunk.
+     *
+     * Предполагается, что isShipSunk(x, y) == true.
+     */
+    void markShipSunk(int x, int y) noexcept;
+};
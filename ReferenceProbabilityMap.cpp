@@ -0,0 +1,101 @@
+﻿#include "ReferenceProbabilityMap.h"
+
+#include <vector>
+
+// ------------------------------------------------------------
+// Проверка возможности разместить корабль
+// ------------------------------------------------------------
+bool ReferenceProbabilityMap::canPlace(
+    const Grid& board,
+    [[maybe_unused]] const ShotsGrid& shots,
+    int x, int y,
+    int length,
+    bool horizontal
+) const noexcept
+{
+    const int dx = horizontal ? 1 : 0;
+    const int dy = horizontal ? 0 : 1;
+
+    for (int i = 0; i < length; ++i) {
+        const int cx = x + dx * i;
+        const int cy = y + dy * i;
+
+        if (!board.isInside(cx, cy))
+            return false;
+
+        const auto cell = board.cells()[cy][cx];
+
+        // Здесь корабля точно нет
+        if (cell == CellState::Miss)
+            return false;
+
+        // Здесь уже лежит добитый корабль — новый тут быть не может
+        if (cell == CellState::Sunk)
+            return false;
+
+        // Ship НЕ запрещаем!
+        // ИИ не знает, где корабли игрока.
+        // Hit допустим — это значит, что корабль проходит через эту клетку.
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------
+// Пересчёт карты вероятностей
+// ------------------------------------------------------------
+void ReferenceProbabilityMap::computeBaseline(
+    const Grid& board,
+    const ShotsGrid& shots,
+    std::span<const int> sizes
+) noexcept
+{
+    // Обнуляем карту
+    for (auto& row : map)
+        row.fill(0);
+
+    // Перебираем все размеры кораблей
+    for (int len : sizes) {
+
+        for (int y = 0; y < static_cast<int>(BOARD_SIZE); ++y) {
+            for (int x = 0; x < static_cast<int>(BOARD_SIZE); ++x) {
+
+                // Горизонтально
+                if (canPlace(board, shots, x, y, len, true)) {
+                    for (int i = 0; i < len; ++i)
+                        map[y][x + i]++;
+                }
+
+                // Вертикально
+                if (canPlace(board, shots, x, y, len, false)) {
+                    for (int i = 0; i < len; ++i)
+                        map[y + i][x]++;
+                }
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Правила нынешнего ИИ поверх исходного пересчёта
+// ------------------------------------------------------------
+void ReferenceProbabilityMap::compute(
+    const BoardGrid& cells,
+    const ShotsGrid& closed,
+    const ShipCounts& weights
+) noexcept
+{
+    // Закрытая клетка для canPlace() — то же, что промах
+    Grid board{ cells };
+    for (std::size_t y = 0; y < BOARD_SIZE; ++y)
+        for (std::size_t x = 0; x < BOARD_SIZE; ++x)
+            if (closed[y][x])
+                board.cells_[y][x] = CellState::Miss;
+
+    // Оставшийся флот: длина len — weights[len] раз
+    std::vector<int> sizes;
+    for (int len = 1; len <= MAX_SHIP_LENGTH; ++len)
+        sizes.insert(sizes.end(), static_cast<std::size_t>(weights[len]), len);
+
+    computeBaseline(board, closed, sizes);
+}
@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <array>
+#include <span>
+
+#include "Board.h"
+#include "GameConfig.h"
+#include "ShotsGrid.h"
+
+/**
+ * @class ReferenceProbabilityMap
+ * @brief Исходный пересчёт карты вероятностей — эталон для сверки
+ *        с ProbabilityMap (полный пересчёт и update()).
+ *
+ * canPlace() и computeBaseline() — первоначальный ProbabilityMap::compute()
+ * без изменений: каждая клетка каждого положения проверяется по очереди,
+ * каждый корабль флота добавляет по единице. Флот передаётся параметром,
+ * а поле — сеткой Grid с теми же isInside() и cells(), что у исходного Board.
+ *
+ * Правила нынешнего ИИ накладывает compute(): клетки closed становятся
+ * промахами, а корабль длины len входит во флот weights[len] раз.
+ */
+class ReferenceProbabilityMap {
+public:
+    std::array<std::array<int, BOARD_SIZE>, BOARD_SIZE> map{};
+
+    void compute(
+        const BoardGrid& cells,
+        const ShotsGrid& closed,
+        const ShipCounts& weights = SHIP_COUNTS
+    ) noexcept;
+
+private:
+    struct Grid {
+        BoardGrid cells_{};
+
+        [[nodiscard]]
+        bool isInside(int x, int y) const noexcept {
+            return x >= 0 && x < static_cast<int>(BOARD_SIZE) &&
+                y >= 0 && y < static_cast<int>(BOARD_SIZE);
+        }
+
+        [[nodiscard]]
+        const BoardGrid& cells() const noexcept { return cells_; }
+    };
+
+    [[nodiscard]]
+    bool canPlace(
+        const Grid& board,
+        const ShotsGrid& shots,
+        int x, int y,
+        int length,
+        bool horizontal
+    ) const noexcept;
+
+    void computeBaseline(
+        const Grid& board,
+        const ShotsGrid& shots,
+        std::span<const int> sizes = SHIP_SIZES
+    ) noexcept;
+};
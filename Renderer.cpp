@@ -1,16 +1,52 @@
 ﻿#include "Renderer.h"
+#include "Profiler.h"
 
-Renderer::Renderer(sf::RenderWindow& window) noexcept
-    : window_(window) {
+Renderer::Renderer(sf::RenderWindow& window)
+    : window_(window)
+    , cells_(sf::Quads, BoardCount * CellCount * 4)
+    , crosses_(sf::Lines, BoardCount * CellCount * 4)
+{
+    // Пустые клетки без крестиков; положения — при первом draw
+    for (std::size_t v = 0; v < cells_.getVertexCount(); ++v) {
+        cells_[v].color = colorOf(CellLook::Default);
+        crosses_[v].color = sf::Color::Transparent;
+    }
+    looks_.fill(CellLook::Default);
+}
+
+// ------------------------------------------------------------
+// Вид клетки
+// ------------------------------------------------------------
+Renderer::CellLook Renderer::lookOf(CellState st, bool showShips) noexcept
+{
+    switch (st) {
+    case CellState::Ship: return showShips ? CellLook::Ship : CellLook::Default;
+    case CellState::Miss: return CellLook::Miss;
+    case CellState::Hit:  return CellLook::Hit;
+    case CellState::Sunk: return CellLook::Sunk;
+    default:              return CellLook::Default;
+    }
 }
 
-void Renderer::drawBoard(const Board& board,
+sf::Color Renderer::colorOf(CellLook look) noexcept
+{
+    switch (look) {
+    case CellLook::Ship: return Style::CellShip;
+    case CellLook::Miss: return Style::CellMiss;
+    case CellLook::Hit:  return Style::CellHit;
+    case CellLook::Sunk: return Style::CellSunk;
+    default:             return Style::CellDefault;
+    }
+}
+
+// ------------------------------------------------------------
+// Положения вершин поля
+// ------------------------------------------------------------
+void Renderer::placeBoard(std::size_t board,
     int offsetX,
-    int offsetY,
-    bool showShips) const noexcept
+    int offsetY) noexcept
 {
-    sf::RectangleShape cellShape(sf::Vector2f(CELL_SIZE - 2, CELL_SIZE - 2));
-    const auto& cells = board.cells();
+    const float size = float(CELL_SIZE - 2);
 
     for (int y = 0; y < BOARD_SIZE; ++y) {
         for (int x = 0; x < BOARD_SIZE; ++x) {
@@ -18,36 +54,47 @@ void Renderer::drawBoard(const Board& board,
             float px = float(offsetX + x * CELL_SIZE + 1);
             float py = float(offsetY + y * CELL_SIZE + 1);
 
-            cellShape.setPosition(px, py);
+            const std::size_t first = (board * CellCount + std::size_t(y * BOARD_SIZE + x)) * 4;
 
-            CellState st = cells[y][x];
-            sf::Color color = Style::CellDefault;
+            cells_[first + 0].position = sf::Vector2f(px, py);
+            cells_[first + 1].position = sf::Vector2f(px + size, py);
+            cells_[first + 2].position = sf::Vector2f(px + size, py + size);
+            cells_[first + 3].position = sf::Vector2f(px, py + size);
 
-            if (showShips && st == CellState::Ship)
-                color = Style::CellShip;
-            if (st == CellState::Miss)
-                color = Style::CellMiss;
-            if (st == CellState::Hit)
-                color = Style::CellHit;
-            if (st == CellState::Sunk)
-                color = Style::CellSunk;
+            crosses_[first + 0].position = sf::Vector2f(px, py);
+            crosses_[first + 1].position = sf::Vector2f(px + size, py + size);
+            crosses_[first + 2].position = sf::Vector2f(px + size, py);
+            crosses_[first + 3].position = sf::Vector2f(px, py + size);
+        }
+    }
 
-            cellShape.setFillColor(color);
-            window_.draw(cellShape);
+    origins_[board] = sf::Vector2i(offsetX, offsetY);
+}
+
+// ------------------------------------------------------------
+// Цвета изменившихся клеток
+// ------------------------------------------------------------
+void Renderer::updateBoard(std::size_t board,
+    const Board& state,
+    bool showShips) noexcept
+{
+    const BoardGrid grid = state.cells();
+
+    for (int y = 0; y < BOARD_SIZE; ++y) {
+        for (int x = 0; x < BOARD_SIZE; ++x) {
 
-            if (st == CellState::Sunk) {
-                sf::Vertex line1[] = {
-                    sf::Vertex(sf::Vector2f(px, py), Style::SunkLine),
-                    sf::Vertex(sf::Vector2f(px + CELL_SIZE - 2, py + CELL_SIZE - 2), Style::SunkLine)
-                };
+            const std::size_t cell = board * CellCount + std::size_t(y * BOARD_SIZE + x);
+            const CellLook look = lookOf(grid[y][x], showShips);
+            if (look == looks_[cell])
+                continue;
 
-                sf::Vertex line2[] = {
-                    sf::Vertex(sf::Vector2f(px + CELL_SIZE - 2, py), Style::SunkLine),
-                    sf::Vertex(sf::Vector2f(px, py + CELL_SIZE - 2), Style::SunkLine)
-                };
+            looks_[cell] = look;
 
-                window_.draw(line1, 2, sf::Lines);
-                window_.draw(line2, 2, sf::Lines);
+            const sf::Color fill = colorOf(look);
+            const sf::Color cross = look == CellLook::Sunk ? Style::SunkLine : sf::Color::Transparent;
+            for (std::size_t v = cell * 4; v < cell * 4 + 4; ++v) {
+                cells_[v].color = fill;
+                crosses_[v].color = cross;
             }
         }
     }
@@ -58,14 +105,34 @@ void Renderer::draw(const Board& playerBoard,
     const sf::Text& statusText,
     int playerBoardX,
     int aiBoardX,
-    int boardsY) const noexcept
+    int boardsY,
+    const sf::Text* overlay) noexcept
 {
+    ProfileScope profile(ProfileZone::Draw);
+
+    const std::array<sf::Vector2i, BoardCount> origins{
+        sf::Vector2i(playerBoardX, boardsY),
+        sf::Vector2i(aiBoardX, boardsY)
+    };
+    for (std::size_t board = 0; board < BoardCount; ++board) {
+        if (!placed_ || origins_[board] != origins[board])
+            placeBoard(board, origins[board].x, origins[board].y);
+    }
+    placed_ = true;
+
+    updateBoard(0, playerBoard, true);
+    updateBoard(1, aiBoard, false);
+
     window_.clear(Style::Background);
 
-    drawBoard(playerBoard, playerBoardX, boardsY, true);
-    drawBoard(aiBoard, aiBoardX, boardsY, false);
+    window_.draw(cells_);
+    window_.draw(crosses_);
 
     window_.draw(statusText);
 
+    if (overlay)
+        window_.draw(*overlay);
+
     window_.display();
+    Profiler::count(ProfileCounter::DrawCalls, overlay ? 4 : 3);
 }
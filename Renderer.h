@@ -1,32 +1,81 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <SFML/Graphics.hpp>
 #include "Board.h"
 #include "GameConfig.h"
 #include "StyleConfig.h"
 
+/**
+ * @class Renderer
+ * @brief      .
+ *
+ *         
+ * (   ),     
+ * (    ,    ). 
+ *      ,   ,
+ *       draw    .
+ *      (Profiler).
+ */
 class Renderer {
 public:
-    explicit Renderer(sf::RenderWindow& window) noexcept;
+    explicit Renderer(sf::RenderWindow& window);
 
-    //      
+    //   ,    (  nullptr) 
     void draw(
         const Board& playerBoard,
         const Board& aiBoard,
         const sf::Text& statusText,
         int playerBoardX,
         int aiBoardX,
-        int boardsY
-    ) const noexcept;
+        int boardsY,
+        const sf::Text* overlay = nullptr
+    ) noexcept;
 
 private:
+    //    
+    enum class CellLook : std::uint8_t {
+        Default,
+        Ship,
+        Miss,
+        Hit,
+        Sunk
+    };
+
+    static constexpr std::size_t BoardCount = 2;
+    static constexpr std::size_t CellCount = BOARD_SIZE * BOARD_SIZE;
+
     sf::RenderWindow& window_;
 
-    //   
-    void drawBoard(
-        const Board& board,
+    //   (4   )   (4   );
+    //   board   board * CellCount
+    sf::VertexArray cells_;
+    sf::VertexArray crosses_;
+
+    // ,      
+    std::array<CellLook, BoardCount * CellCount> looks_{};
+
+    //    ,    
+    std::array<sf::Vector2i, BoardCount> origins_{};
+    bool placed_ = false;
+
+    //     st (    showShips)
+    static CellLook lookOf(CellState st, bool showShips) noexcept;
+
+    static sf::Color colorOf(CellLook look) noexcept;
+
+    //    board   (offsetX, offsetY)
+    void placeBoard(
+        std::size_t board,
         int offsetX,
-        int offsetY,
+        int offsetY
+    ) noexcept;
+
+    //    board,   
+    void updateBoard(
+        std::size_t board,
+        const Board& state,
         bool showShips
-    ) const noexcept;
+    ) noexcept;
 };
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "Bitboard.h"
+#include "GameRules.h"
+#include "InlineVector.h"
+
+/**
+ * @struct BasicShip
+ * @brief Корабль, стоящий на поле.
+ *
+ * Хранит положение первой палубы, длину, ориентацию
+ * и готовую маску всех палуб.
+ */
+template <class Rules>
+struct BasicShip {
+    int x = 0;                ///< первая палуба (левая или верхняя)
+    int y = 0;
+    int length = 0;           ///< число палуб
+    bool horizontal = true;   ///< ориентация
+    typename Rules::Bitboard body;   ///< маска палуб
+};
+
+// Флот: по одному кораблю на каждый элемент Rules::ShipSizes, в том же порядке
+template <class Rules>
+using BasicFleet = std::array<BasicShip<Rules>, Rules::ShipSizes.size()>;
+
+using Ship = BasicShip<ClassicRules>;
+using Fleet = BasicFleet<ClassicRules>;
+
+// Длины кораблей флота (без выделения памяти)
+template <class Rules>
+using BasicShipLengths = InlineVector<int, Rules::ShipSizes.size()>;
+
+/**
+ * @brief Длины затопленных кораблей по маске затопленных палуб.
+ */
+template <class Rules>
+[[nodiscard]]
+constexpr BasicShipLengths<Rules> sunkShipLengths(const typename Rules::Bitboard& sunk) noexcept {
+    constexpr int n = static_cast<int>(Rules::BoardSize);
+    BasicShipLengths<Rules> lengths;
+    const auto starts = sunk & ~sunk.east() & ~sunk.south();
+
+    starts.forEach([&](std::size_t index) {
+        const int x = static_cast<int>(index % Rules::BoardSize);
+        const int y = static_cast<int>(index / Rules::BoardSize);
+
+        int len = 1;
+        if (x + 1 < n && sunk.test(index + 1)) {
+            while (x + len < n && sunk.test(index + static_cast<std::size_t>(len)))
+                ++len;
+        }
+        else {
+            while (y + len < n && sunk.test(index + static_cast<std::size_t>(len) * Rules::BoardSize))
+                ++len;
+        }
+        lengths.push_back(len);
+        });
+    return lengths;
+}
+
+/**
+ * @brief Длины оставшихся кораблей (Rules::ShipSizes минус затопленные), по убыванию.
+ */
+template <class Rules>
+[[nodiscard]]
+constexpr BasicShipLengths<Rules> remainingShipLengths(const typename Rules::Bitboard& sunkDecks) noexcept {
+    BasicShipLengths<Rules> sunk = sunkShipLengths<Rules>(sunkDecks);
+    BasicShipLengths<Rules> remaining;
+
+    for (int len : Rules::ShipSizes) {
+        auto it = std::find(sunk.begin(), sunk.end(), len);
+        if (it != sunk.end()) {
+            *it = sunk.back();
+            sunk.pop_back();
+            continue;
+        }
+        remaining.push_back(len);
+    }
+
+    // По убыванию вставками: кораблей не больше флота, а std::sort по
+    // InlineVector даёт ложное -Warray-bounds за пределами size()
+    for (std::size_t i = 1; i < remaining.size(); ++i)
+        for (std::size_t j = i; j > 0 && remaining[j - 1] < remaining[j]; --j)
+            std::swap(remaining[j - 1], remaining[j]);
+    return remaining;
+}
@@ -0,0 +1,161 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "Bitboard.h"
+#include "GameRules.h"
+
+/**
+ * @struct BasicShipPlacement
+ * @brief Одно положение корабля на пустом поле.
+ */
+template <class Rules>
+struct BasicShipPlacement {
+    typename Rules::Bitboard body;   ///< палубы
+    typename Rules::Bitboard halo;   ///< палубы вместе с окружением 3x3
+    typename Rules::Bitboard ring;   ///< окружение без палуб
+};
+
+/**
+ * @brief Число положений корабля длины length на пустом поле size x size
+ *        (однопалубному — одно положение на клетку).
+ */
+[[nodiscard]]
+constexpr std::size_t shipPlacementCount(std::size_t size, int length) noexcept {
+    const std::size_t fits = size - static_cast<std::size_t>(length) + 1;
+    return length == 1 ? size * size : 2 * size * fits;
+}
+
+/**
+ * @struct BasicShipPlacementTable
+ * @brief Все положения кораблей длин 1..Rules::MaxShipLength.
+ *
+ * Порядок внутри длины — по строкам, затем по столбцам, горизонтальное
+ * раньше вертикального. Однопалубному соответствует одно положение на
+ * клетку (горизонталь и вертикаль совпадают), иначе при переборе оно
+ * считалось бы дважды.
+ */
+template <class Rules>
+struct BasicShipPlacementTable {
+    static constexpr std::size_t Total = [] {
+        std::size_t total = 0;
+        for (int len = 1; len <= Rules::MaxShipLength; ++len)
+            total += shipPlacementCount(Rules::BoardSize, len);
+        return total;
+    }();
+
+    // Нет положения (корабль не помещается)
+    static constexpr std::int16_t None = -1;
+
+    std::array<BasicShipPlacement<Rules>, Total> all{};
+    std::array<std::size_t, Rules::MaxShipLength + 2> firstOfLength{};   ///< all упорядочен по длине
+
+    // at[len][клетка * 2 + вертикальное] — номер в all (None — за краем поля)
+    std::array<std::array<std::int16_t, 2 * Rules::Cells>, Rules::MaxShipLength + 1> at{};
+
+    static_assert(Total <= 32767, "номер положения хранится в std::int16_t");
+};
+
+/**
+ * @brief Таблица положений, построенная при компиляции из правил:
+ *        ни инициализации, ни блокировок при первом вызове.
+ */
+template <class Rules>
+inline constexpr BasicShipPlacementTable<Rules> shipPlacementTable = [] {
+    using Table = BasicShipPlacementTable<Rules>;
+    using Bitboard = typename Rules::Bitboard;
+
+    Table t;
+    constexpr int n = static_cast<int>(Rules::BoardSize);
+
+    std::size_t next = 0;
+    for (int len = 1; len <= Rules::MaxShipLength; ++len) {
+        t.firstOfLength[len] = next;
+        t.at[len].fill(Table::None);
+
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                const std::size_t cell = Bitboard::indexOf(x, y);
+
+                for (bool horizontal : { true, false }) {
+                    const int dx = horizontal ? 1 : 0;
+                    const int dy = horizontal ? 0 : 1;
+                    if (x + dx * (len - 1) >= n || y + dy * (len - 1) >= n)
+                        continue;
+
+                    if (len == 1 && !horizontal) {
+                        t.at[len][cell * 2 + 1] = t.at[len][cell * 2];
+                        continue;
+                    }
+
+                    // Окружение — прямоугольник вокруг палуб, обрезанный краями поля
+                    // (поклеточно: сдвиги масок дороже при вычислении при компиляции)
+                    BasicShipPlacement<Rules>& p = t.all[next];
+                    const int right = std::min(x + dx * (len - 1) + 1, n - 1);
+                    const int bottom = std::min(y + dy * (len - 1) + 1, n - 1);
+                    for (int cy = std::max(y - 1, 0); cy <= bottom; ++cy)
+                        for (int cx = std::max(x - 1, 0); cx <= right; ++cx)
+                            p.halo.set(Bitboard::indexOf(cx, cy));
+                    for (int i = 0; i < len; ++i)
+                        p.body.set(Bitboard::indexOf(x + dx * i, y + dy * i));
+                    p.ring = p.halo ^ p.body;
+
+                    t.at[len][cell * 2 + (horizontal ? 0 : 1)] = static_cast<std::int16_t>(next);
+                    ++next;
+                }
+            }
+        }
+    }
+    t.firstOfLength[Rules::MaxShipLength + 1] = next;
+    return t;
+}();
+
+/**
+ * @brief Все положения корабля длины length (1..Rules::MaxShipLength).
+ */
+template <class Rules>
+[[nodiscard]]
+constexpr std::span<const BasicShipPlacement<Rules>> shipPlacements(int length) noexcept {
+    const auto& table = shipPlacementTable<Rules>;
+    const std::size_t first = table.firstOfLength[length];
+    return { table.all.data() + first, table.firstOfLength[length + 1] - first };
+}
+
+/**
+ * @brief Положение корабля с началом (x, y) (nullptr — корабль
+ *        не помещается на поле или длина вне 1..Rules::MaxShipLength).
+ */
+template <class Rules>
+[[nodiscard]]
+constexpr const BasicShipPlacement<Rules>* shipPlacementAt(int x, int y, int length, bool horizontal) noexcept {
+    using Table = BasicShipPlacementTable<Rules>;
+    constexpr int n = static_cast<int>(Rules::BoardSize);
+    if (x < 0 || x >= n || y < 0 || y >= n || length < 1 || length > Rules::MaxShipLength)
+        return nullptr;
+
+    const auto& table = shipPlacementTable<Rules>;
+    const std::int16_t id = table.at[length][Rules::Bitboard::indexOf(x, y) * 2 + (horizontal ? 0 : 1)];
+    return id == Table::None ? nullptr : &table.all[static_cast<std::size_t>(id)];
+}
+
+// Положения классического поля
+using ShipPlacement = BasicShipPlacement<ClassicRules>;
+using ShipPlacementTable = BasicShipPlacementTable<ClassicRules>;
+
+inline constexpr const ShipPlacementTable& SHIP_PLACEMENTS = shipPlacementTable<ClassicRules>;
+
+[[nodiscard]]
+constexpr std::span<const ShipPlacement> shipPlacements(int length) noexcept {
+    return shipPlacements<ClassicRules>(length);
+}
+
+[[nodiscard]]
+constexpr const ShipPlacement* shipPlacementAt(int x, int y, int length, bool horizontal) noexcept {
+    return shipPlacementAt<ClassicRules>(x, y, length, horizontal);
+}
+
+// Больше положений одной длины не бывает
+inline constexpr std::size_t MAX_PLACEMENTS_PER_LENGTH = 2 * BOARD_SIZE * BOARD_SIZE;
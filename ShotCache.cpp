@@ -0,0 +1,55 @@
+﻿#include "ShotCache.h"
+
+#include <algorithm>
+#include <bit>
+
+// ------------------------------------------------------------
+// Конструктор: вся память — сразу
+// ------------------------------------------------------------
+ShotCache::ShotCache(std::size_t entries, std::size_t shards)
+    : shardCount_(std::bit_ceil(std::max<std::size_t>(shards, 1))),
+    slotsPerShard_(std::max<std::size_t>((entries + shardCount_ - 1) / shardCount_, 1))
+{
+    shards_ = std::make_unique<Shard[]>(shardCount_);
+    for (std::size_t i = 0; i < shardCount_; ++i)
+        shards_[i].entries.resize(slotsPerShard_);
+}
+
+// ------------------------------------------------------------
+// Поиск и вставка
+// ------------------------------------------------------------
+std::optional<Bitboard> ShotCache::find(std::uint64_t key) noexcept {
+    Shard& shard = shardOf(key);
+    const std::lock_guard lock(shard.mutex);
+
+    const Entry& entry = shard.entries[slotOf(key)];
+    if (entry.used && entry.key == key) {
+        ++shard.stats.hits;
+        return entry.best;
+    }
+    ++shard.stats.misses;
+    return std::nullopt;
+}
+
+void ShotCache::insert(std::uint64_t key, const Bitboard& best) noexcept {
+    Shard& shard = shardOf(key);
+    const std::lock_guard lock(shard.mutex);
+
+    Entry& entry = shard.entries[slotOf(key)];
+    entry.key = key;
+    entry.best = best;
+    entry.used = true;
+}
+
+// ------------------------------------------------------------
+// Счётчики
+// ------------------------------------------------------------
+ShotCacheStats ShotCache::stats() const noexcept {
+    ShotCacheStats total;
+    for (std::size_t i = 0; i < shardCount_; ++i) {
+        const std::lock_guard lock(shards_[i].mutex);
+        total.hits += shards_[i].stats.hits;
+        total.misses += shards_[i].stats.misses;
+    }
+    return total;
+}
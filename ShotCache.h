@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Bitboard.h"
+
+/**
+ * @struct ShotCacheStats
+ * @brief Счётчики обращений к кэшу.
+ */
+struct ShotCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+
+    [[nodiscard]]
+    double hitRate() const noexcept {
+        const std::uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+/**
+ * @class ShotCache
+ * @brief Потокобезопасный кэш выбора ИИ по хешу видимого состояния
+ *        поля (Board::observedHash).
+ *
+ * Значение — клетки с наибольшей оценкой; среди них ИИ выбирает
+ * случайно так же, как без кэша. Таблица фиксированного размера
+ * разбита на шарды, у каждого свой мьютекс и свои счётчики, поэтому
+ * потоки симуляции почти не ждут друг друга. Внутри шарда — прямое
+ * отображение: новый ключ вытесняет старый. Память выделяется только
+ * в конструкторе, поиск и вставка кучу не трогают.
+ *
+ * Один кэш — на одни настройки ИИ: при других настройках тому же
+ * состоянию соответствует другой выбор.
+ */
+class ShotCache {
+public:
+    /**
+     * @param entries  число записей (округляется вверх до кратного числу шардов)
+     * @param shards   число шардов (округляется вверх до степени двойки)
+     */
+    explicit ShotCache(std::size_t entries, std::size_t shards = 64);
+
+    /**
+     * @brief Лучшие клетки для состояния key (std::nullopt — промах кэша).
+     */
+    [[nodiscard]]
+    std::optional<Bitboard> find(std::uint64_t key) noexcept;
+
+    void insert(std::uint64_t key, const Bitboard& best) noexcept;
+
+    /**
+     * @brief Сумма счётчиков всех шардов.
+     */
+    [[nodiscard]]
+    ShotCacheStats stats() const noexcept;
+
+    [[nodiscard]]
+    std::size_t capacity() const noexcept { return shardCount_ * slotsPerShard_; }
+
+    /**
+     * @brief Вызывает f(key, best) для каждой записи (например, чтобы
+     *        сохранить кэш в дебютную книгу). Шард заблокирован на время обхода.
+     */
+    template <class F>
+    void forEach(F&& f) const {
+        for (std::size_t i = 0; i < shardCount_; ++i) {
+            const std::lock_guard lock(shards_[i].mutex);
+            for (const Entry& entry : shards_[i].entries)
+                if (entry.used)
+                    f(entry.key, entry.best);
+        }
+    }
+
+private:
+    struct Entry {
+        std::uint64_t key = 0;
+        Bitboard best;
+        bool used = false;
+    };
+
+    // Шард на своей строке кэша, чтобы мьютексы и счётчики соседей не мешали
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::vector<Entry> entries;
+        ShotCacheStats stats;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    std::size_t shardCount_ = 0;
+    std::size_t slotsPerShard_ = 0;
+
+    [[nodiscard]]
+    Shard& shardOf(std::uint64_t key) const noexcept {
+        return shards_[static_cast<std::size_t>(key) & (shardCount_ - 1)];
+    }
+
+    [[nodiscard]]
+    std::size_t slotOf(std::uint64_t key) const noexcept {
+        return static_cast<std::size_t>(key >> 32) % slotsPerShard_;
+    }
+};
@@ -9,5 +9,5 @@ enum class ShotResult : unsigned char {
     Repeat,     ///<  
     Miss,       ///< 
     Hit,        ///< 
-    Sunk        ///<  
+    Sunk        ///<   (  . Board::lastSunk)
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <array>
 #include "GameConfig.h"
 
@@ -10,4 +11,7 @@
  *  true ,     .
  *  false     .
  */
-using ShotsGrid = std::array<std::array<bool, BOARD_SIZE>, BOARD_SIZE>;
+template <std::size_t Size>
+using BasicShotsGrid = std::array<std::array<bool, Size>, Size>;
+
+using ShotsGrid = BasicShotsGrid<BOARD_SIZE>;
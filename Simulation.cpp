@@ -0,0 +1,381 @@
+﻿#include "Simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AIController.h"
+#include "AllocationCounter.h"
+#include "ProbabilityMap.h"
+#include "Board.h"
+#include "FleetSampler.h"
+#include "ThreadPool.h"
+
+namespace {
+
+    // Партий в одном куске работы потока
+    constexpr std::size_t GamesPerChunk = 256;
+
+    // Накопитель одного потока (выровнен, чтобы потоки не делили строку кэша)
+    struct alignas(64) Partial {
+        std::array<std::uint64_t, MAX_RULES_CELLS + 1> shotsToWin{};
+        std::uint64_t unfinished = 0;
+        std::vector<std::uint64_t> unfinishedFleets;
+        std::uint64_t allocatingTurns = 0;
+        std::uint64_t mapSamples = 0;
+        double mapSeconds = 0.0;
+        std::uint64_t endgameTurns = 0;
+        std::uint64_t mapTurns = 0;
+        std::uint64_t livePlacements = 0;
+        std::uint64_t bookMoves = 0;
+        LogHistogram turnNanos;
+    };
+
+} // namespace
+
+// ------------------------------------------------------------
+//  Генератор партии
+// ------------------------------------------------------------
+std::mt19937 gameRng(std::uint64_t seed, std::uint64_t game) {
+    std::seed_seq seq{
+        static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+        static_cast<std::uint32_t>(game), static_cast<std::uint32_t>(game >> 32)
+    };
+    return std::mt19937(seq);
+}
+
+// ------------------------------------------------------------
+//  Настройка ИИ
+// ------------------------------------------------------------
+void configureAi(AIController& ai, const AiSettings& settings) {
+    if (settings.search)
+        ai.enableSearch(*settings.search);
+    if (settings.monteCarlo)
+        ai.enableMonteCarloMap(*settings.monteCarlo);
+    if (settings.endgame)
+        ai.enableEndgameSolver(*settings.endgame);
+    ai.setShotCache(settings.cache);
+    ai.setOpeningBook(settings.book);
+}
+
+// ------------------------------------------------------------
+//  Одна партия
+// ------------------------------------------------------------
+template <class Rules>
+GameOutcome playAiGame(
+    std::mt19937& rng,
+    LogHistogram* turnNanos,
+    const AiSettings& settings,
+    const FleetSampler* fleets
+) {
+    using Clock = std::chrono::steady_clock;
+
+    GameOutcome outcome;
+    BasicBoard<Rules> board;
+    if constexpr (IsClassicRules<Rules>) {
+        if (!fleets)
+            board.randomPlaceFleet(rng);
+        else if (!board.placeFleet(fleets->sample(rng)))
+            return outcome;   // сэмплер даёт только допустимые флоты
+    }
+    else {
+        board.randomPlaceFleet(rng);
+    }
+
+    BasicAIController<Rules> ai(rng);
+    if constexpr (IsClassicRules<Rules>)
+        configureAi(ai, settings);
+    BasicShotsGrid<Rules::BoardSize> shots{};
+    bool playerTurn = false;
+    bool playerWon = false;
+
+    std::uint64_t mapUpdates = 0;
+    while (outcome.shots < static_cast<int>(Rules::Cells)) {
+        const AllocationScope allocations;
+        const auto start = turnNanos ? Clock::now() : Clock::time_point{};
+        const bool over = ai.takeTurn(board, shots, playerTurn, playerWon);
+
+        if (allocations.count())
+            ++outcome.allocatingTurns;
+
+        if constexpr (IsClassicRules<Rules>) {
+            if (settings.endgame && ai.lastEndgame().solved)
+                ++outcome.endgameTurns;
+
+            if (const MonteCarloMap* map = ai.monteCarloMap()) {
+                outcome.mapSamples += map->stats().samples;
+                outcome.mapSeconds += map->stats().seconds;
+            }
+        }
+
+        const auto& prob = ai.probabilityMap();
+        if (prob.updates() != mapUpdates) {
+            mapUpdates = prob.updates();
+            ++outcome.mapTurns;
+            outcome.livePlacements += prob.livePlacements();
+        }
+
+        if (turnNanos) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            turnNanos->add(static_cast<std::uint64_t>(ns));
+        }
+
+        ++outcome.shots;
+        if (over) {
+            outcome.finished = true;
+            break;
+        }
+    }
+    outcome.bookMoves = ai.bookMoves();
+
+    // По ID флот незаконченной партии воспроизводится без seed
+    if constexpr (IsClassicRules<Rules>) {
+        if (!outcome.finished)
+            outcome.fleetId = (fleets ? *fleets : FleetSampler::instance()).rank(board.ships());
+    }
+    return outcome;
+}
+
+#define RULES_INSTANTIATE(Rules, name) \
+    template GameOutcome playAiGame<Rules>(std::mt19937&, LogHistogram*, const AiSettings&, const FleetSampler*);
+RULES_VARIANTS(RULES_INSTANTIATE)
+#undef RULES_INSTANTIATE
+
+// ------------------------------------------------------------
+//  Прогон на пуле потоков
+// ------------------------------------------------------------
+SimulationReport runSimulation(const SimulationConfig& config) {
+    // Правила проверяются до запуска потоков
+    bool classic = false;
+    if (!withRules(config.rules, [&](auto tag) { classic = IsClassicRules<typename decltype(tag)::type>; })) {
+        std::cerr << "Неизвестные правила: " << config.rules << '\n';
+        return {};
+    }
+    if (!classic && (config.ai.search || config.ai.monteCarlo || config.ai.endgame || config.ai.book)) {
+        std::cerr << "Поиск, Монте-Карло, эндшпиль и дебютная книга есть только для правил classic\n";
+        return {};
+    }
+    if (!classic && config.uniformFleets) {
+        std::cerr << "Равномерные флоты (FleetSampler) есть только для правил classic\n";
+        return {};
+    }
+    const FleetSampler* fleets = config.uniformFleets ? &FleetSampler::instance() : nullptr;
+
+    ThreadPool pool(config.threads);
+    std::vector<Partial> partials(pool.size());
+
+    AiSettings ai = config.ai;
+    if (ai.search)
+        ai.search->threads = 1;
+    if (ai.monteCarlo)
+        ai.monteCarlo->threads = 1;
+
+    // Один кэш на все потоки: одинаковые видимые состояния встречаются
+    // в разных партиях (прежде всего первые ходы)
+    std::optional<ShotCache> cache;
+    if (config.cacheEntries && classic) {
+        cache.emplace(config.cacheEntries);
+        ai.cache = &*cache;
+    }
+
+    SimulationReport report;
+    const auto start = std::chrono::steady_clock::now();
+
+    withRules(config.rules, [&](auto tag) {
+        using Rules = typename decltype(tag)::type;
+        report.cells = Rules::Cells;
+        report.placements = PlacementCount<Rules>;
+
+        pool.parallelFor(config.games, GamesPerChunk, [&](std::size_t begin, std::size_t end, unsigned worker) {
+            Partial& partial = partials[worker];
+            LogHistogram* turns = config.timeTurns ? &partial.turnNanos : nullptr;
+
+            for (std::size_t game = begin; game < end; ++game) {
+                std::mt19937 rng = gameRng(config.seed, game);
+                const GameOutcome outcome = playAiGame<Rules>(rng, turns, ai, fleets);
+
+                if (outcome.finished)
+                    ++partial.shotsToWin[static_cast<std::size_t>(outcome.shots)];
+                else
+                    ++partial.unfinished;
+                if (outcome.fleetId)
+                    partial.unfinishedFleets.push_back(*outcome.fleetId);
+                partial.allocatingTurns += static_cast<std::uint64_t>(outcome.allocatingTurns);
+                partial.mapSamples += outcome.mapSamples;
+                partial.mapSeconds += outcome.mapSeconds;
+                partial.endgameTurns += static_cast<std::uint64_t>(outcome.endgameTurns);
+                partial.mapTurns += static_cast<std::uint64_t>(outcome.mapTurns);
+                partial.livePlacements += outcome.livePlacements;
+                partial.bookMoves += static_cast<std::uint64_t>(outcome.bookMoves);
+            }
+            });
+        });
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.games = config.games;
+    report.threads = pool.size();
+    if (cache)
+        report.cache = cache->stats();
+
+    for (const Partial& partial : partials) {
+        for (std::size_t n = 0; n < partial.shotsToWin.size(); ++n)
+            report.shotsToWin[n] += partial.shotsToWin[n];
+        report.unfinished += partial.unfinished;
+        report.unfinishedFleets.insert(report.unfinishedFleets.end(),
+            partial.unfinishedFleets.begin(), partial.unfinishedFleets.end());
+        report.allocatingTurns += partial.allocatingTurns;
+        report.mapSamples += partial.mapSamples;
+        report.mapSeconds += partial.mapSeconds;
+        report.endgameTurns += partial.endgameTurns;
+        report.mapTurns += partial.mapTurns;
+        report.livePlacements += partial.livePlacements;
+        report.bookMoves += partial.bookMoves;
+        report.turnNanos.merge(partial.turnNanos);
+    }
+    std::sort(report.unfinishedFleets.begin(), report.unfinishedFleets.end());
+    return report;
+}
+
+// ------------------------------------------------------------
+//  Статистика сводки
+// ------------------------------------------------------------
+double SimulationReport::gamesPerSecond() const noexcept {
+    return seconds > 0.0 ? static_cast<double>(games) / seconds : 0.0;
+}
+
+double SimulationReport::meanShots() const noexcept {
+    std::uint64_t won = 0;
+    double sum = 0.0;
+    for (std::size_t n = 0; n < shotsToWin.size(); ++n) {
+        won += shotsToWin[n];
+        sum += static_cast<double>(n) * static_cast<double>(shotsToWin[n]);
+    }
+    return won ? sum / static_cast<double>(won) : 0.0;
+}
+
+double SimulationReport::stddevShots() const noexcept {
+    const double mean = meanShots();
+    std::uint64_t won = 0;
+    double sum = 0.0;
+    for (std::size_t n = 0; n < shotsToWin.size(); ++n) {
+        const double d = static_cast<double>(n) - mean;
+        won += shotsToWin[n];
+        sum += d * d * static_cast<double>(shotsToWin[n]);
+    }
+    return won > 1 ? std::sqrt(sum / static_cast<double>(won - 1)) : 0.0;
+}
+
+double SimulationReport::meanLivePlacements() const noexcept {
+    return mapTurns ? static_cast<double>(livePlacements) / static_cast<double>(mapTurns) : 0.0;
+}
+
+int SimulationReport::shotsPercentile(double q) const noexcept {
+    std::uint64_t won = 0;
+    for (auto c : shotsToWin)
+        won += c;
+    if (won == 0)
+        return 0;
+
+    auto rank = static_cast<std::uint64_t>(q * static_cast<double>(won));
+    rank = std::min(rank, won - 1);
+
+    std::uint64_t seen = 0;
+    for (std::size_t n = 0; n < shotsToWin.size(); ++n) {
+        seen += shotsToWin[n];
+        if (seen > rank)
+            return static_cast<int>(n);
+    }
+    return static_cast<int>(shotsToWin.size()) - 1;
+}
+
+// ------------------------------------------------------------
+//  Печать сводки
+// ------------------------------------------------------------
+void printReport(std::ostream& out, const SimulationReport& report) {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << std::fixed << std::setprecision(2);
+    out << "Партий: " << report.games
+        << "  потоков: " << report.threads
+        << "  время: " << report.seconds << " с"
+        << "  партий/с: " << std::setprecision(0) << report.gamesPerSecond() << '\n';
+
+    if (report.unfinished)
+        out << "Не закончено за " << report.cells << " выстрелов: " << report.unfinished << '\n';
+    if (!report.unfinishedFleets.empty()) {
+        out << "  ID флотов:";
+        for (std::uint64_t id : report.unfinishedFleets)
+            out << ' ' << id;
+        out << '\n';
+    }
+
+    out << "Ходов ИИ с выделением памяти: " << report.allocatingTurns << '\n';
+
+    if (const std::uint64_t lookups = report.cache.hits + report.cache.misses)
+        out << "Кэш выбора: обращений " << lookups << "  попаданий " << report.cache.hits
+            << " (" << std::setprecision(1) << 100.0 * report.cache.hitRate() << "%)\n";
+
+    if (report.bookMoves)
+        out << "Ходов из дебютной книги: " << report.bookMoves << '\n';
+
+    if (report.mapSamples && report.mapSeconds > 0.0)
+        out << "Карта Монте-Карло: выборок/с в потоке " << std::setprecision(0)
+            << static_cast<double>(report.mapSamples) / report.mapSeconds << '\n';
+
+    if (report.endgameTurns)
+        out << "Ходов точного эндшпиля: " << report.endgameTurns << '\n';
+
+    if (report.mapTurns)
+        out << "Вероятностная карта: ходов " << report.mapTurns
+            << "  положений за ход в среднем " << std::setprecision(1)
+            << report.meanLivePlacements() << " из " << report.placements << '\n';
+
+    out << std::setprecision(3)
+        << "Выстрелов до победы: среднее " << report.meanShots()
+        << "  ст.откл. " << report.stddevShots()
+        << "  p50 " << report.shotsPercentile(0.50)
+        << "  p90 " << report.shotsPercentile(0.90)
+        << "  p99 " << report.shotsPercentile(0.99)
+        << '\n';
+
+    // Распределение: по строке на каждое встретившееся число выстрелов
+    const std::uint64_t peak = *std::max_element(report.shotsToWin.begin(), report.shotsToWin.end());
+    std::uint64_t won = 0;
+    for (auto c : report.shotsToWin)
+        won += c;
+
+    for (std::size_t n = 0; n < report.shotsToWin.size() && peak > 0; ++n) {
+        const std::uint64_t c = report.shotsToWin[n];
+        if (c == 0)
+            continue;
+
+        const auto bar = static_cast<std::size_t>(50.0 * static_cast<double>(c) / static_cast<double>(peak));
+        out << std::setw(5) << n << ' '
+            << std::setw(10) << c << ' '
+            << std::setw(7) << 100.0 * static_cast<double>(c) / static_cast<double>(won) << '%';
+        if (bar)
+            out << ' ' << std::string(bar, '#');
+        out << '\n';
+    }
+
+    const LogHistogram& t = report.turnNanos;
+    if (t.count()) {
+        auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+        out << "Ход ИИ, мкс: среднее " << t.mean() / 1000.0
+            << "  p50 " << us(t.percentile(0.50))
+            << "  p90 " << us(t.percentile(0.90))
+            << "  p99 " << us(t.percentile(0.99))
+            << "  p99.9 " << us(t.percentile(0.999))
+            << "  макс " << us(t.max())
+            << "  (ходов: " << t.count() << ")\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,177 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Bitboard.h"
+#include "Histogram.h"
+#include "LookaheadSearch.h"
+#include "MonteCarloMap.h"
+#include "EndgameSolver.h"
+#include "GameRules.h"
+#include "ShotCache.h"
+
+class FleetSampler;
+class OpeningBook;
+template <class Rules>
+class BasicAIController;
+using AIController = BasicAIController<ClassicRules>;
+
+/**
+ * @file Simulation.h
+ * @brief Пакетный прогон партий ИИ против случайного флота без окна.
+ *
+ * Каждая партия: Board::randomPlaceFleet (или равномерно случайный флот
+ * FleetSampler, см. SimulationConfig::uniformFleets), затем
+ * AIController::takeTurn до уничтожения всего флота. Каждый ход проверяется на выделение
+ * памяти (AllocationCounter.h). Партии раздаются по пулу потоков;
+ * генератор каждой партии зависит только от seed и номера партии,
+ * поэтому результат не зависит от числа потоков.
+ *
+ * Правила партии выбираются по имени (SimulationConfig::rules, см.
+ * GameRules.h); поиск, Монте-Карло, эндшпиль, кэш и книга — только
+ * для классических.
+ */
+
+// Выбор хода ИИ (по умолчанию — жадно по ProbabilityMap).
+// Партии и так идут параллельно, поэтому внутри партии всё — в один поток.
+struct AiSettings {
+    std::optional<SearchConfig> search;           ///< упреждающий поиск
+    std::optional<MonteCarloConfig> monteCarlo;   ///< карта Монте-Карло
+    std::optional<EndgameConfig> endgame;         ///< точный решатель эндшпиля
+    ShotCache* cache = nullptr;                   ///< общий кэш выбора (nullptr — без кэша)
+    const OpeningBook* book = nullptr;            ///< дебютная книга (nullptr — без книги)
+
+    // Ход ИИ обязан обходиться без кучи (решатель эндшпиля держит таблицу)
+    [[nodiscard]]
+    bool allocationFree() const noexcept { return !endgame; }
+};
+
+// Параметры прогона
+struct SimulationConfig {
+    std::uint64_t games = 10000;
+    std::uint64_t seed = 1;
+    unsigned threads = 0;       ///< 0 — по числу ядер
+    bool timeTurns = true;      ///< замерять задержку каждого хода ИИ
+    std::size_t cacheEntries = 0;         ///< записей общего ShotCache (0 — без кэша; с кэшем поиск и Монте-Карло зависят от числа потоков)
+    std::string rules = "classic";        ///< вариант правил (RULES_NAMES)
+    AiSettings ai;
+
+    // Флоты равномерно по всем расстановкам (FleetSampler, только classic).
+    // randomPlaceFleet ставит корабли по одному и смещает распределение флотов;
+    // таблицы сэмплера строятся ~1,5 с и занимают ~100 МБ, поэтому по запросу.
+    bool uniformFleets = false;
+};
+
+// Итог одной партии
+struct GameOutcome {
+    int shots = 0;              ///< выстрелов до победы (или до остановки)
+    bool finished = false;      ///< флот уничтожен
+    int allocatingTurns = 0;    ///< ходов ИИ, выделявших память
+    std::uint64_t mapSamples = 0;   ///< выборок карты Монте-Карло за партию
+    int endgameTurns = 0;           ///< ходов, выбранных точным решателем
+    double mapSeconds = 0.0;        ///< время их выборки
+    int mapTurns = 0;                   ///< ходов по вероятностной карте
+    std::uint64_t livePlacements = 0;   ///< сумма по этим ходам положений в карте
+    int bookMoves = 0;                  ///< ходов из дебютной книги
+    std::optional<std::uint64_t> fleetId;   ///< ID флота (FleetSampler) незаконченной партии classic
+};
+
+// Сводка прогона
+struct SimulationReport {
+    std::uint64_t games = 0;
+    std::uint64_t unfinished = 0;   ///< партии, не законченные за cells выстрелов
+    std::vector<std::uint64_t> unfinishedFleets;   ///< их ID флотов (FleetSampler), по возрастанию
+    std::uint64_t allocatingTurns = 0;  ///< ходов ИИ, выделявших память (должно быть 0)
+    std::uint64_t mapSamples = 0;       ///< выборок карты Монте-Карло (всего по ходам)
+    std::uint64_t endgameTurns = 0;     ///< ходов, выбранных точным решателем
+    double mapSeconds = 0.0;            ///< суммарное время этих выборок
+    std::uint64_t mapTurns = 0;         ///< ходов по вероятностной карте
+    std::uint64_t livePlacements = 0;   ///< сумма по этим ходам положений в карте
+    ShotCacheStats cache;               ///< обращения к ShotCache
+    std::uint64_t bookMoves = 0;        ///< ходов из дебютной книги
+    unsigned threads = 0;
+    double seconds = 0.0;
+    std::size_t cells = 0;              ///< клеток поля
+    std::size_t placements = 0;         ///< положений кораблей в карте на пустом поле
+
+    // shotsToWin[n] — число партий, выигранных ровно за n выстрелов
+    std::array<std::uint64_t, MAX_RULES_CELLS + 1> shotsToWin{};
+
+    // Задержка одного хода ИИ, нс
+    LogHistogram turnNanos;
+
+    [[nodiscard]]
+    double gamesPerSecond() const noexcept;
+
+    [[nodiscard]]
+    double meanShots() const noexcept;
+
+    [[nodiscard]]
+    double stddevShots() const noexcept;
+
+    /**
+     * @brief Положений в вероятностной карте в среднем за ход по ней
+     *        (без закрытых клеток и затопленных длин).
+     */
+    [[nodiscard]]
+    double meanLivePlacements() const noexcept;
+
+    /**
+     * @brief Квантиль числа выстрелов до победы (q в [0, 1]).
+     */
+    [[nodiscard]]
+    int shotsPercentile(double q) const noexcept;
+};
+
+/**
+ * @brief Генератор партии номер game для прогона с данным seed.
+ */
+[[nodiscard]]
+std::mt19937 gameRng(std::uint64_t seed, std::uint64_t game);
+
+/**
+ * @brief Включает в контроллере способы выбора хода из settings.
+ */
+void configureAi(AIController& ai, const AiSettings& settings);
+
+/**
+ * @brief Одна партия ИИ против случайной расстановки.
+ *
+ * Собрана для всех вариантов из RULES_VARIANTS; для остальных правил
+ * настройки ai и fleets, кроме классических, не действуют.
+ * Незаконченная партия classic получает ID флота (первый такой
+ * случай строит таблицы FleetSampler).
+ *
+ * @param turnNanos  куда добавлять задержку каждого хода (nullptr — не замерять)
+ * @param ai         выбор хода ИИ
+ * @param fleets     откуда брать флот (nullptr — Board::randomPlaceFleet)
+ */
+template <class Rules = ClassicRules>
+[[nodiscard]]
+GameOutcome playAiGame(
+    std::mt19937& rng,
+    LogHistogram* turnNanos,
+    const AiSettings& ai = {},
+    const FleetSampler* fleets = nullptr
+);
+
+/**
+ * @brief Прогон config.games партий на пуле потоков.
+ *
+ * Неизвестные правила или настройки, недоступные для них, — пустая
+ * сводка (games == 0) и причина в std::cerr.
+ */
+[[nodiscard]]
+SimulationReport runSimulation(const SimulationConfig& config);
+
+/**
+ * @brief Печать сводки: распределение выстрелов, партий в секунду,
+ *        квантили задержки хода.
+ */
+void printReport(std::ostream& out, const SimulationReport& report);
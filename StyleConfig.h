@@ -37,4 +37,7 @@ namespace Style {
 
     //  .
     inline const sf::Color TextColor = sf::Color::White;
+
+    //    (F3).
+    inline const sf::Color OverlayText = sf::Color(255, 220, 120);
 }
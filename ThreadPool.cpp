@@ -0,0 +1,76 @@
+﻿#include "ThreadPool.h"
+
+namespace {
+    thread_local unsigned currentWorker = 0;
+}
+
+// ------------------------------------------------------------
+//  Запуск и остановка потоков
+// ------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        workers_.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& t : workers_)
+        t.join();
+}
+
+unsigned ThreadPool::workerIndex() noexcept {
+    return currentWorker;
+}
+
+// ------------------------------------------------------------
+//  Очередь задач
+// ------------------------------------------------------------
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return tasks_.empty() && running_ == 0; });
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    currentWorker = index;
+
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+            if (tasks_.empty())
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++running_;
+        }
+
+        task();
+
+        {
+            std::lock_guard lock(mutex_);
+            --running_;
+            if (tasks_.empty() && running_ == 0)
+                idle_.notify_all();
+        }
+    }
+}
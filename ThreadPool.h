@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Пул рабочих потоков с общей очередью задач.
+ *
+ * Каждый поток знает свой номер (workerIndex()), поэтому задачи
+ * могут копить результаты в массиве «по одному на поток» без
+ * блокировок и сливать их после wait().
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threads  число потоков; 0 — по числу ядер
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]]
+    unsigned size() const noexcept { return static_cast<unsigned>(workers_.size()); }
+
+    /**
+     * @brief Добавляет задачу в очередь.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Ждёт, пока очередь опустеет и все задачи завершатся.
+     */
+    void wait();
+
+    /**
+     * @brief Номер текущего рабочего потока, от 0 до size() - 1 (вне пула — 0).
+     */
+    [[nodiscard]]
+    static unsigned workerIndex() noexcept;
+
+    /**
+     * @brief Параллельный цикл по [0, count) кусками по chunk.
+     *
+     * Куски раздаются по мере освобождения потоков.
+     * body(begin, end, worker) вызывается для каждого куска;
+     * возврат — после обработки всех кусков.
+     */
+    template <class F>
+    void parallelFor(std::size_t count, std::size_t chunk, F&& body) {
+        if (count == 0)
+            return;
+        if (chunk == 0)
+            chunk = 1;
+
+        std::atomic<std::size_t> next{ 0 };
+        for (unsigned t = 0; t < size(); ++t) {
+            submit([&] {
+                const unsigned worker = workerIndex();
+                for (;;) {
+                    const std::size_t begin = next.fetch_add(chunk, std::memory_order_relaxed);
+                    if (begin >= count)
+                        return;
+                    body(begin, std::min(count, begin + chunk), worker);
+                }
+                });
+        }
+        wait();
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;    ///< появилась задача или пора выходить
+    std::condition_variable idle_;    ///< очередь пуста и никто не работает
+
+    std::size_t running_ = 0;
+    bool stopping_ = false;
+
+    void workerLoop(unsigned index);
+};
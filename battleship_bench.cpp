@@ -0,0 +1,402 @@
+﻿#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AIController.h"
+#include "Board.h"
+#include "ProbabilityMap.h"
+#include "ShotsGrid.h"
+#include "Simulation.h"
+
+// ------------------------------------------------------------
+//  Замеры горячих функций и целой партии
+//
+//  battleship_bench [--filter TEXT] [--reps N] [--warmup N] [--min-ms N]
+//                   [--save FILE] [--compare FILE] [--threshold PCT]
+//
+//  Каждый замер — повторы по пакету операций; размер пакета
+//  подбирается так, чтобы пакет шёл не меньше min-ms. Сначала warmup
+//  пакетов без учёта, затем reps пакетов; по ним — медиана, среднее,
+//  отклонение, минимум и максимум наносекунд на операцию.
+//
+//  --save пишет медианы в JSON (базовая линия), --compare сравнивает
+//  с сохранённой: медиана хуже базовой больше чем на PCT% (по
+//  умолчанию 5) — регрессия, код возврата 4.
+// ------------------------------------------------------------
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Результаты замеров копятся сюда, чтобы компилятор их не выбросил
+    volatile std::uint64_t sink = 0;
+
+    /**
+     * Замер: run(n) выполняет n повторов и возвращает число
+     * выполненных операций (партия — переменное число ходов).
+     */
+    struct Benchmark {
+        std::string name;
+        std::string unit;
+        std::function<std::uint64_t(std::uint64_t)> run;
+    };
+
+    struct Stats {
+        double median = 0;
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+        double max = 0;
+        std::uint64_t batch = 0;    ///< повторов в пакете
+    };
+
+    struct Options {
+        std::string filter;
+        std::uint64_t reps = 15;
+        std::uint64_t warmup = 3;
+        std::uint64_t minMs = 50;
+        std::string savePath;
+        std::string comparePath;
+        double threshold = 5.0;
+    };
+
+    void printUsage() {
+        std::cerr << "Использование: battleship_bench [--filter TEXT] [--reps N] [--warmup N] [--min-ms N]\n"
+                     "                        [--save FILE] [--compare FILE] [--threshold PCT]\n";
+    }
+
+    bool parseNumber(const char* text, std::uint64_t& value) {
+        char* end = nullptr;
+        value = std::strtoull(text, &end, 10);
+        return end && *end == '\0' && end != text;
+    }
+
+    bool parseNumber(const char* text, double& value) {
+        char* end = nullptr;
+        value = std::strtod(text, &end);
+        return end && *end == '\0' && end != text && value >= 0.0;
+    }
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // ------------------------------------------------------------
+    //  Прогон одного замера
+    // ------------------------------------------------------------
+    Stats measure(const Benchmark& bench, const Options& options) {
+        // Пакет удваивается, пока не займёт min-ms
+        const double minSeconds = static_cast<double>(options.minMs) / 1000.0;
+        std::uint64_t batch = 1;
+        for (;;) {
+            const auto start = Clock::now();
+            bench.run(batch);
+            if (secondsSince(start) >= minSeconds || batch >= (std::uint64_t{ 1 } << 40))
+                break;
+            batch *= 2;
+        }
+
+        for (std::uint64_t i = 0; i < options.warmup; ++i)
+            bench.run(batch);
+
+        std::vector<double> perOp;
+        perOp.reserve(options.reps);
+        for (std::uint64_t i = 0; i < options.reps; ++i) {
+            const auto start = Clock::now();
+            const std::uint64_t ops = bench.run(batch);
+            const double seconds = secondsSince(start);
+            perOp.push_back(seconds * 1e9 / static_cast<double>(std::max<std::uint64_t>(ops, 1)));
+        }
+
+        Stats stats;
+        stats.batch = batch;
+        std::sort(perOp.begin(), perOp.end());
+        const std::size_t n = perOp.size();
+        stats.median = n % 2 ? perOp[n / 2] : (perOp[n / 2 - 1] + perOp[n / 2]) / 2.0;
+        stats.mean = std::accumulate(perOp.begin(), perOp.end(), 0.0) / static_cast<double>(n);
+        double squares = 0;
+        for (double v : perOp)
+            squares += (v - stats.mean) * (v - stats.mean);
+        stats.stddev = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+        stats.min = perOp.front();
+        stats.max = perOp.back();
+        return stats;
+    }
+
+    // ------------------------------------------------------------
+    //  Позиции для замеров
+    // ------------------------------------------------------------
+
+    // Состояния партии ИИ: поле и его выстрелы после каждого хода
+    struct Position {
+        Board board;
+        ShotsGrid shots{};
+    };
+
+    std::vector<Position> collectPositions(std::uint64_t games, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::vector<Position> positions;
+
+        for (std::uint64_t g = 0; g < games; ++g) {
+            Position position;
+            position.board.randomPlaceFleet(rng);
+            AIController ai(rng);
+            bool playerTurn = false;
+            bool playerWon = false;
+            bool over = false;
+            while (!over) {
+                positions.push_back(position);
+                over = ai.takeTurn(position.board, position.shots, playerTurn, playerWon);
+            }
+        }
+        return positions;
+    }
+
+    // ------------------------------------------------------------
+    //  Замеры
+    // ------------------------------------------------------------
+    std::vector<Benchmark> makeBenchmarks() {
+        std::vector<Benchmark> benchmarks;
+
+        // Board::shoot: все клетки 64 полей в случайном порядке
+        // (в замер входит и копирование поля перед обстрелом)
+        {
+            auto boards = std::make_shared<std::vector<Board>>(64);
+            auto orders = std::make_shared<std::vector<std::array<std::uint8_t, BOARD_SIZE * BOARD_SIZE>>>(boards->size());
+            std::mt19937 rng(1);
+            for (std::size_t i = 0; i < boards->size(); ++i) {
+                (*boards)[i].randomPlaceFleet(rng);
+                std::iota((*orders)[i].begin(), (*orders)[i].end(), std::uint8_t{ 0 });
+                std::shuffle((*orders)[i].begin(), (*orders)[i].end(), rng);
+            }
+
+            auto work = std::make_shared<Board>();
+            benchmarks.push_back({ "board_shoot", "выстрел", [boards, orders, work](std::uint64_t n) {
+                std::uint64_t hits = 0;
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    const std::size_t b = i % boards->size();
+                    *work = (*boards)[b];
+                    for (std::uint8_t cell : (*orders)[b])
+                        hits += work->shoot(cell % BOARD_SIZE, cell / BOARD_SIZE) != ShotResult::Miss;
+                }
+                sink = sink + hits;
+                return n * BOARD_SIZE * BOARD_SIZE;
+                } });
+        }
+
+        // Board::randomPlaceFleet
+        {
+            auto rng = std::make_shared<std::mt19937>(2);
+            auto board = std::make_shared<Board>();
+            benchmarks.push_back({ "board_place_fleet", "расстановка", [rng, board](std::uint64_t n) {
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    board->randomPlaceFleet(*rng);
+                    sink = sink + static_cast<std::uint64_t>(board->ships().count());
+                }
+                return n;
+                } });
+        }
+
+        // ProbabilityMap::compute по позициям реальных партий
+        auto positions = std::make_shared<std::vector<Position>>(collectPositions(32, 3));
+        {
+            auto map = std::make_shared<ProbabilityMap>();
+            benchmarks.push_back({ "probability_map_compute", "пересчёт", [positions, map](std::uint64_t n) {
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    const Position& p = (*positions)[i % positions->size()];
+                    map->compute(p.board, p.shots);
+                    sink = sink + static_cast<std::uint64_t>(map->map[0][0]);
+                }
+                return n;
+                } });
+        }
+
+        // AIController::takeTurn: партии целиком, операция — ход
+        // (расстановка и новый ИИ на партию входят в замер)
+        {
+            auto rng = std::make_shared<std::mt19937>(4);
+            benchmarks.push_back({ "ai_take_turn", "ход", [rng](std::uint64_t n) {
+                std::uint64_t turns = 0;
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    Board board;
+                    board.randomPlaceFleet(*rng);
+                    AIController ai(*rng);
+                    ShotsGrid shots{};
+                    bool playerTurn = false;
+                    bool playerWon = false;
+                    bool over = false;
+                    for (std::size_t turn = 0; turn < BOARD_SIZE * BOARD_SIZE && !over; ++turn) {
+                        over = ai.takeTurn(board, shots, playerTurn, playerWon);
+                        ++turns;
+                    }
+                }
+                return turns;
+                } });
+        }
+
+        // Партия целиком (playAiGame, как в battleship_sim)
+        {
+            auto rng = std::make_shared<std::mt19937>(5);
+            benchmarks.push_back({ "full_game", "партия", [rng](std::uint64_t n) {
+                for (std::uint64_t i = 0; i < n; ++i)
+                    sink = sink + static_cast<std::uint64_t>(playAiGame(*rng, nullptr).shots);
+                return n;
+                } });
+        }
+
+        return benchmarks;
+    }
+
+    // ------------------------------------------------------------
+    //  Базовая линия (JSON)
+    // ------------------------------------------------------------
+    bool saveBaseline(const std::string& path, const std::vector<std::pair<const Benchmark*, Stats>>& results) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+            return false;
+
+        out << std::setprecision(6) << "{\n  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& [bench, s] = results[i];
+            out << "    {\"name\": \"" << bench->name << "\""
+                << ", \"median_ns\": " << s.median
+                << ", \"mean_ns\": " << s.mean
+                << ", \"stddev_ns\": " << s.stddev
+                << ", \"min_ns\": " << s.min
+                << ", \"max_ns\": " << s.max
+                << ", \"batch\": " << s.batch << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    // Медианы по именам из файла saveBaseline (разбор только этого формата)
+    bool loadBaseline(const std::string& path, std::map<std::string, double>& medians) {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const std::string text = buffer.str();
+
+        const std::string nameKey = "\"name\": \"";
+        const std::string medianKey = "\"median_ns\": ";
+        for (std::size_t pos = text.find(nameKey); pos != std::string::npos; pos = text.find(nameKey, pos)) {
+            pos += nameKey.size();
+            const std::size_t nameEnd = text.find('"', pos);
+            const std::size_t median = text.find(medianKey, pos);
+            if (nameEnd == std::string::npos || median == std::string::npos)
+                return false;
+            medians[text.substr(pos, nameEnd - pos)] = std::strtod(text.c_str() + median + medianKey.size(), nullptr);
+        }
+        return !medians.empty();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        std::uint64_t number = 0;
+
+        if (arg == "--filter")
+            options.filter = value;
+        else if (arg == "--save")
+            options.savePath = value;
+        else if (arg == "--compare")
+            options.comparePath = value;
+        else if (arg == "--threshold") {
+            if (!parseNumber(value, options.threshold)) {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (!parseNumber(value, number)) {
+            printUsage();
+            return 1;
+        }
+        else if (arg == "--reps")
+            options.reps = std::max<std::uint64_t>(number, 1);
+        else if (arg == "--warmup")
+            options.warmup = number;
+        else if (arg == "--min-ms")
+            options.minMs = number;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.comparePath.empty() && !loadBaseline(options.comparePath, baseline)) {
+        std::cerr << "Не удалось прочитать базовую линию " << options.comparePath << '\n';
+        return 1;
+    }
+
+    const std::vector<Benchmark> benchmarks = makeBenchmarks();
+    std::vector<std::pair<const Benchmark*, Stats>> results;
+    int regressions = 0;
+
+    std::cout << std::fixed
+              << "замер                      нс/оп (медиана)   среднее  откл., %   минимум  операция";
+    if (!baseline.empty())
+        std::cout << "    к базе";
+    std::cout << '\n';
+
+    for (const Benchmark& bench : benchmarks) {
+        if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos)
+            continue;
+
+        const Stats s = measure(bench, options);
+        results.emplace_back(&bench, s);
+
+        std::cout << std::left << std::setw(26) << bench.name << std::right
+                  << std::setw(16) << std::setprecision(2) << s.median
+                  << std::setw(10) << s.mean
+                  << std::setw(10) << std::setprecision(1) << (s.mean > 0 ? 100.0 * s.stddev / s.mean : 0.0)
+                  << std::setw(10) << std::setprecision(2) << s.min
+                  << "  " << bench.unit;
+
+        if (auto it = baseline.find(bench.name); it != baseline.end() && it->second > 0) {
+            const double change = 100.0 * (s.median - it->second) / it->second;
+            std::cout << "  " << std::showpos << std::setprecision(1) << change << '%' << std::noshowpos;
+            if (change > options.threshold) {
+                std::cout << "  РЕГРЕССИЯ";
+                ++regressions;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.savePath.empty() && !saveBaseline(options.savePath, results)) {
+        std::cerr << "Не удалось записать базовую линию " << options.savePath << '\n';
+        return 1;
+    }
+
+    if (regressions) {
+        std::cerr << "Регрессий: " << regressions << " (порог " << options.threshold << "%)\n";
+        return 4;
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+﻿#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "OpeningBook.h"
+
+// ------------------------------------------------------------
+//  Построение дебютной книги самоигрой
+//
+//  battleship_book [--out FILE] [--games N] [--depth N] [--seed N] [--threads N]
+//                  [--search-nodes N] [--search-ms N] [--search-plies 1|2] [--mc-samples N]
+//
+//  Книга годится только для ИИ с теми же настройками выбора хода
+//  (те же --search-* или --mc-samples у battleship_sim); их отпечаток
+//  пишется в заголовок, и OpeningBook::open() чужую книгу не откроет.
+//  Игра ищет по времени — для неё книгу строят с --search-ms 4500.
+// ------------------------------------------------------------
+namespace {
+
+    void printUsage() {
+        std::cerr << "Использование: battleship_book [--out FILE] [--games N] [--depth N] [--seed N] [--threads N]\n"
+                     "                       [--search-nodes N] [--search-ms N] [--search-plies 1|2] [--mc-samples N]\n";
+    }
+
+    bool parseNumber(const char* text, std::uint64_t& value) {
+        char* end = nullptr;
+        value = std::strtoull(text, &end, 10);
+        return end && *end == '\0' && end != text;
+    }
+
+    SearchConfig& searchConfig(OpeningBookConfig& config) {
+        if (!config.ai.search)
+            config.ai.search.emplace();
+        return *config.ai.search;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    OpeningBookConfig config;
+    std::string out = "opening.book";
+    bool nodesGiven = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::uint64_t value = 0;
+
+        if (arg == "--out" && i + 1 < argc) {
+            out = argv[++i];
+            continue;
+        }
+
+        if (i + 1 >= argc || !parseNumber(argv[i + 1], value)) {
+            printUsage();
+            return 1;
+        }
+        ++i;
+
+        if (arg == "--games")
+            config.games = value;
+        else if (arg == "--depth")
+            config.depth = static_cast<int>(value);
+        else if (arg == "--seed")
+            config.seed = value;
+        else if (arg == "--threads")
+            config.threads = static_cast<unsigned>(value);
+        else if (arg == "--search-nodes") {
+            searchConfig(config).nodes = value;
+            nodesGiven = true;
+        }
+        else if (arg == "--search-ms")
+            searchConfig(config).seconds = static_cast<double>(value) / 1000.0;
+        else if (arg == "--search-plies")
+            searchConfig(config).plies = static_cast<int>(value);
+        else if (arg == "--mc-samples")
+            config.ai.monteCarlo = MonteCarloConfig{ value, 1 };
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Только --search-ms — бюджет лишь по времени (как у battleship_sim)
+    if (config.ai.search && config.ai.search->seconds > 0.0 && !nodesGiven)
+        config.ai.search->nodes = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto entries = generateOpeningBook(config);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!OpeningBook::write(out, entries, config.depth, config.ai))
+        return 1;
+
+    std::cout << "Дебютная книга " << out << ": записей " << entries.size()
+              << "  партий " << config.games << "  глубина " << config.depth
+              << "  время " << seconds << " с\n";
+    return 0;
+}
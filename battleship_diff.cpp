@@ -0,0 +1,412 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "Coord.h"
+#include "FleetSampler.h"
+#include "ProbabilityMap.h"
+#include "ReferenceBoard.h"
+#include "ReferenceProbabilityMap.h"
+#include "ShotsGrid.h"
+#include "ThreadPool.h"
+
+// ------------------------------------------------------------
+//  Сверка Board и ProbabilityMap с эталонами
+//
+//  battleship_diff [--cases N] [--threads N] [--seed N]
+//  battleship_diff --replay SEED [--shots "x,y x,y ..."]
+//
+//  Случай SEED — случайная расстановка Board::randomPlaceFleet и
+//  выстрелы по всем клеткам в случайном порядке вперемешку с
+//  повторными и выходящими за поле. После каждого выстрела
+//  сравниваются результат, сетка поля и конец партии с ReferenceBoard,
+//  а карта ProbabilityMap (полный пересчёт и update()) — с
+//  ReferenceProbabilityMap; закрытые клетки — окружение затопленных,
+//  веса — незатопленные корабли. Номер флота FleetSampler проверяется
+//  в обе стороны: rank() расстановки случая и unrank() случайного
+//  номера должны возвращаться к исходным. Случаи SEED, SEED + 1, ... идут по
+//  пулу потоков. Первое расхождение сокращается до минимального списка
+//  выстрелов и печатается вместе с командой --replay; код возврата 2.
+// ------------------------------------------------------------
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using Shots = std::vector<Coord>;
+
+    void printUsage() {
+        std::cerr << "Использование: battleship_diff [--cases N] [--threads N] [--seed N]\n"
+                     "               battleship_diff --replay SEED [--shots \"x,y x,y ...\"]\n";
+    }
+
+    bool parseNumber(const char* text, std::uint64_t& value) {
+        char* end = nullptr;
+        value = std::strtoull(text, &end, 10);
+        return end && *end == '\0' && end != text;
+    }
+
+    bool parseShots(const std::string& text, Shots& shots) {
+        std::istringstream in(text);
+        std::string item;
+        while (in >> item) {
+            int x = 0;
+            int y = 0;
+            char comma = 0;
+            std::istringstream pair(item);
+            if (!(pair >> x >> comma >> y) || comma != ',')
+                return false;
+            shots.emplace_back(x, y);
+        }
+        return true;
+    }
+
+    std::string formatShots(std::span<const Coord> shots) {
+        std::string text;
+        for (const Coord& c : shots) {
+            if (!text.empty())
+                text += ' ';
+            text += std::to_string(c.x) + ',' + std::to_string(c.y);
+        }
+        return text;
+    }
+
+    // ------------------------------------------------------------
+    //  Случай: расстановка и выстрелы по seed
+    // ------------------------------------------------------------
+    std::mt19937 caseRng(std::uint64_t seed) {
+        std::seed_seq seq{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) };
+        return std::mt19937(seq);
+    }
+
+    Board makeBoard(std::mt19937& rng) {
+        Board board;
+        board.randomPlaceFleet(rng);
+        return board;
+    }
+
+    Shots makeShots(std::mt19937& rng) {
+        Shots shots;
+        for (int y = 0; y < static_cast<int>(BOARD_SIZE); ++y)
+            for (int x = 0; x < static_cast<int>(BOARD_SIZE); ++x)
+                shots.emplace_back(x, y);
+        std::shuffle(shots.begin(), shots.end(), rng);
+
+        // Повторные выстрелы и выстрелы за край поля
+        std::uniform_int_distribution<std::size_t> extra(0, 12);
+        std::uniform_int_distribution<int> side(-1, BOARD_SIZE);
+        const std::size_t count = extra(rng);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uniform_int_distribution<std::size_t> at(0, shots.size());
+            const Coord shot = i % 2 ? shots[at(rng) % shots.size()] : Coord{ side(rng), side(rng) };
+            shots.insert(shots.begin() + static_cast<std::ptrdiff_t>(at(rng)), shot);
+        }
+        return shots;
+    }
+
+    // ------------------------------------------------------------
+    //  Сверка
+    // ------------------------------------------------------------
+    const char* resultName(ShotResult r) {
+        switch (r) {
+        case ShotResult::Miss:    return "Miss";
+        case ShotResult::Hit:     return "Hit";
+        case ShotResult::Sunk:    return "Sunk";
+        case ShotResult::Repeat:  return "Repeat";
+        case ShotResult::Invalid: return "Invalid";
+        default:                  return "?";
+        }
+    }
+
+    template <class Map, class RefMap>
+    std::string compareMaps(const char* what, const Map& map, const RefMap& ref) {
+        for (int y = 0; y < static_cast<int>(BOARD_SIZE); ++y) {
+            for (int x = 0; x < static_cast<int>(BOARD_SIZE); ++x) {
+                if (map[y][x] != ref[y][x]) {
+                    return std::string(what) + ": клетка " + std::to_string(x) + ',' + std::to_string(y)
+                        + " — " + std::to_string(map[y][x]) + ", эталон " + std::to_string(ref[y][x]);
+                }
+            }
+        }
+        return {};
+    }
+
+    /**
+     * Прогоняет выстрелы shots по полю start и эталону.
+     * Пустая строка — совпало; иначе первое расхождение.
+     */
+    std::string replay(const Board& start, std::span<const Coord> shots) {
+        Board board = start;
+        ReferenceBoard reference(start.cells());
+
+        ProbabilityMap full;
+        ProbabilityMap incremental;
+        ReferenceProbabilityMap referenceMap;
+
+        ShotsGrid fired{};
+        ShotsGrid closed{};
+        Bitboard closedBits;
+        ShipCounts weights = SHIP_COUNTS;
+
+        incremental.compute(board, fired, closedBits, weights);
+        referenceMap.compute(reference.cells(), closed, weights);
+        if (std::string diff = compareMaps("ProbabilityMap::compute", incremental.map, referenceMap.map); !diff.empty())
+            return "до выстрелов, " + diff;
+
+        for (std::size_t k = 0; k < shots.size(); ++k) {
+            const auto [x, y] = shots[k];
+            auto where = [&, x = x, y = y] {
+                return "выстрел #" + std::to_string(k + 1) + " (" + std::to_string(x) + ',' + std::to_string(y) + ")";
+            };
+
+            int sunkBefore = 0;
+            for (const auto& row : reference.cells())
+                sunkBefore += static_cast<int>(std::count(row.begin(), row.end(), CellState::Sunk));
+
+            const ShotResult got = board.shoot(x, y);
+            const ShotResult expected = reference.shoot(x, y);
+            if (got != expected)
+                return where() + ": Board " + resultName(got) + ", эталон " + resultName(expected);
+
+            if (board.cells() != reference.cells())
+                return where() + ": сетка поля расходится";
+            if (board.allShipsDestroyed() != reference.allShipsDestroyed())
+                return where() + ": конец партии расходится";
+
+            if (reference.isInside(x, y))
+                fired[y][x] = true;
+
+            // Затопленный корабль: вес его длины убывает, окружение закрывается
+            if (expected == ShotResult::Sunk) {
+                int sunkAfter = 0;
+                for (const auto& row : reference.cells())
+                    sunkAfter += static_cast<int>(std::count(row.begin(), row.end(), CellState::Sunk));
+                const int length = sunkAfter - sunkBefore;
+                if (length >= 1 && length <= MAX_SHIP_LENGTH && weights[length] > 0)
+                    --weights[length];
+
+                for (int cy = 0; cy < static_cast<int>(BOARD_SIZE); ++cy) {
+                    for (int cx = 0; cx < static_cast<int>(BOARD_SIZE); ++cx) {
+                        if (reference.cells()[cy][cx] != CellState::Sunk)
+                            continue;
+                        for (int ny = cy - 1; ny <= cy + 1; ++ny) {
+                            for (int nx = cx - 1; nx <= cx + 1; ++nx) {
+                                if (!reference.isInside(nx, ny) || reference.cells()[ny][nx] == CellState::Sunk)
+                                    continue;
+                                closed[ny][nx] = true;
+                                closedBits.set(Bitboard::indexOf(nx, ny));
+                            }
+                        }
+                    }
+                }
+            }
+
+            full.compute(board, fired, closedBits, weights);
+            incremental.update(board, closedBits, weights);
+            referenceMap.compute(reference.cells(), closed, weights);
+
+            if (std::string diff = compareMaps("ProbabilityMap::compute", full.map, referenceMap.map); !diff.empty())
+                return where() + ", " + diff;
+            if (std::string diff = compareMaps("ProbabilityMap::update", incremental.map, referenceMap.map); !diff.empty())
+                return where() + ", " + diff;
+        }
+        return {};
+    }
+
+    /**
+     * Сокращает выстрелы, пока расхождение остаётся: выбрасываются
+     * куски от половины списка до одного выстрела.
+     */
+    Shots minimize(const Board& start, Shots shots) {
+        for (std::size_t chunk = std::max<std::size_t>(shots.size() / 2, 1);; chunk = std::max<std::size_t>(chunk / 2, 1)) {
+            bool removed = false;
+            for (std::size_t begin = 0; begin < shots.size();) {
+                Shots shorter = shots;
+                const std::size_t end = std::min(shots.size(), begin + chunk);
+                shorter.erase(shorter.begin() + static_cast<std::ptrdiff_t>(begin), shorter.begin() + static_cast<std::ptrdiff_t>(end));
+                if (!replay(start, shorter).empty()) {
+                    shots = std::move(shorter);
+                    removed = true;
+                }
+                else {
+                    begin += chunk;
+                }
+            }
+            if (chunk == 1 && !removed)
+                return shots;
+        }
+    }
+
+    // Расстановка кораблей (клетки Ship), по строке на ряд поля
+    void printBoard(std::ostream& out, const Board& board) {
+        const BoardGrid grid = board.cells();
+        for (const auto& row : grid) {
+            out << "  ";
+            for (CellState cell : row)
+                out << (cell == CellState::Ship ? '#' : '.');
+            out << '\n';
+        }
+    }
+
+    /**
+     * Номер флота: rank() расстановки board и unrank() случайного
+     * номера (по seed) должны переходить друг в друга.
+     * Пустая строка — совпало; иначе расхождение.
+     */
+    std::string checkFleetIds(const Board& board, std::uint64_t seed) {
+        const FleetSampler& sampler = FleetSampler::instance();
+
+        const std::optional<std::uint64_t> id = sampler.rank(board.ships());
+        if (!id || *id >= sampler.count())
+            return "FleetSampler::rank: нет номера у допустимой расстановки";
+
+        Board restored;
+        if (!restored.placeFleet(sampler.unrank(*id)) || restored.ships() != board.ships())
+            return "FleetSampler::unrank(" + std::to_string(*id) + "): другая расстановка";
+
+        std::mt19937_64 rng(seed);
+        const std::uint64_t random = std::uniform_int_distribution<std::uint64_t>(0, sampler.count() - 1)(rng);
+        if (!restored.placeFleet(sampler.unrank(random)))
+            return "FleetSampler::unrank(" + std::to_string(random) + "): недопустимая расстановка";
+        if (sampler.rank(restored.ships()) != random)
+            return "FleetSampler::rank(unrank(" + std::to_string(random) + ")): другой номер";
+        return {};
+    }
+
+    void printFleetId(std::ostream& out, const Board& board) {
+        out << "Расстановка (ID флота ";
+        if (const std::optional<std::uint64_t> id = FleetSampler::instance().rank(board.ships()))
+            out << *id;
+        else
+            out << "нет";
+        out << "):\n";
+    }
+
+    int report(std::uint64_t seed, const Board& board, const Shots& shots) {
+        if (std::string diff = checkFleetIds(board, seed); !diff.empty()) {
+            std::cout << "Расхождение в случае " << seed << ":\n  " << diff << '\n';
+            printFleetId(std::cout, board);
+            printBoard(std::cout, board);
+            std::cout << "Повтор: battleship_diff --replay " << seed << '\n';
+            return 2;
+        }
+
+        const Shots minimal = minimize(board, shots);
+        std::cout << "Расхождение в случае " << seed << ":\n  " << replay(board, minimal) << '\n';
+        printFleetId(std::cout, board);
+        printBoard(std::cout, board);
+        std::cout << "Выстрелы (" << minimal.size() << " из " << shots.size() << "): " << formatShots(minimal) << '\n'
+                  << "Повтор: battleship_diff --replay " << seed << " --shots \"" << formatShots(minimal) << "\"\n";
+        return 2;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t cases = 100000;
+    std::uint64_t threads = 0;
+    std::uint64_t seed = 1;
+    bool replayOnly = false;
+    std::uint64_t replaySeed = 0;
+    bool shotsGiven = false;
+    Shots givenShots;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::uint64_t value = 0;
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        if (arg == "--shots") {
+            if (!parseShots(argv[++i], givenShots)) {
+                printUsage();
+                return 1;
+            }
+            shotsGiven = true;
+            continue;
+        }
+
+        if (!parseNumber(argv[++i], value)) {
+            printUsage();
+            return 1;
+        }
+
+        if (arg == "--cases")
+            cases = value;
+        else if (arg == "--threads")
+            threads = value;
+        else if (arg == "--seed")
+            seed = value;
+        else if (arg == "--replay") {
+            replayOnly = true;
+            replaySeed = value;
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Один случай: заданные выстрелы или выстрелы этого seed
+    if (replayOnly) {
+        std::mt19937 rng = caseRng(replaySeed);
+        const Board board = makeBoard(rng);
+        const Shots shots = shotsGiven ? givenShots : makeShots(rng);
+        if (checkFleetIds(board, replaySeed).empty() && replay(board, shots).empty()) {
+            std::cout << "Случай " << replaySeed << ": совпадает (" << shots.size() << " выстрелов)\n";
+            return 0;
+        }
+        return report(replaySeed, board, shots);
+    }
+
+    // Случаи после уже найденного расхождения не проверяются: первое
+    // расхождение (наименьший номер) не зависит от числа потоков
+    std::atomic<std::uint64_t> firstFailure{ std::numeric_limits<std::uint64_t>::max() };
+    std::atomic<std::uint64_t> totalShots{ 0 };
+
+    // Таблицы FleetSampler строятся до замера времени
+    (void)FleetSampler::instance();
+
+    const auto start = Clock::now();
+    ThreadPool pool(static_cast<unsigned>(threads));
+    pool.parallelFor(static_cast<std::size_t>(cases), 256, [&](std::size_t begin, std::size_t end, unsigned) {
+        std::uint64_t shotCount = 0;
+        for (std::size_t i = begin; i < end && i < firstFailure.load(std::memory_order_relaxed); ++i) {
+            std::mt19937 rng = caseRng(seed + i);
+            const Board board = makeBoard(rng);
+            const Shots shots = makeShots(rng);
+            shotCount += shots.size();
+
+            if (!checkFleetIds(board, seed + i).empty() || !replay(board, shots).empty()) {
+                std::uint64_t current = firstFailure.load(std::memory_order_relaxed);
+                while (i < current && !firstFailure.compare_exchange_weak(current, i, std::memory_order_relaxed)) {
+                }
+                break;
+            }
+        }
+        totalShots.fetch_add(shotCount, std::memory_order_relaxed);
+        });
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const std::uint64_t failure = firstFailure.load();
+    if (failure != std::numeric_limits<std::uint64_t>::max()) {
+        std::mt19937 rng = caseRng(seed + failure);
+        const Board board = makeBoard(rng);
+        return report(seed + failure, board, makeShots(rng));
+    }
+
+    std::cout << "Случаев: " << cases << ", выстрелов: " << totalShots.load()
+              << ", потоков: " << pool.size() << ", " << seconds << " с — расхождений нет\n";
+    return 0;
+}
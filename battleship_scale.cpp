@@ -0,0 +1,158 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GameConfig.h"
+#include "LargeProbabilityMap.h"
+
+// ------------------------------------------------------------
+//  Масштабирование карты покрытия на больших полях
+//
+//  battleship_scale [--max N] [--turns N] [--threads N] [--seed N] [--closed P]
+//
+//  Поля 10, 32, 100, 316, 1000, ... до N (клеток — в 10 раз больше на
+//  шаг). Флот — классический на каждые 100 клеток, P% клеток закрыто
+//  (середина партии). Ход — пересчёт карты и выбор лучшей клетки,
+//  которая затем закрывается. Для сравнения — прямой перебор положений
+//  на первом ходе (он же проверяет карту).
+// ------------------------------------------------------------
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    void printUsage() {
+        std::cerr << "Использование: battleship_scale [--max N] [--turns N] [--threads N] [--seed N] [--closed P]\n";
+    }
+
+    bool parseNumber(const char* text, std::uint64_t& value) {
+        char* end = nullptr;
+        value = std::strtoull(text, &end, 10);
+        return end && *end == '\0' && end != text;
+    }
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Прямой перебор: каждое положение каждой длины проверяется клетка за клеткой
+    std::vector<int> bruteCoverage(std::size_t n, const std::vector<std::uint8_t>& blocked, const std::vector<int>& weights) {
+        std::vector<int> map(n * n, 0);
+        for (std::size_t len = 1; len < weights.size(); ++len) {
+            if (weights[len] == 0 || len > n)
+                continue;
+            for (std::size_t y = 0; y < n; ++y) {
+                for (std::size_t x = 0; x < n; ++x) {
+                    for (std::size_t step : { std::size_t{ 1 }, n }) {
+                        const bool horizontal = step == 1;
+                        if ((horizontal ? x : y) + len > n)
+                            continue;
+
+                        const std::size_t first = y * n + x;
+                        bool free = true;
+                        for (std::size_t i = 0; i < len && free; ++i)
+                            free = !blocked[first + i * step];
+                        if (!free)
+                            continue;
+                        for (std::size_t i = 0; i < len; ++i)
+                            map[first + i * step] += weights[len];
+                    }
+                }
+            }
+        }
+        return map;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t maxSize = 1000;
+    std::uint64_t turns = 20;
+    std::uint64_t threads = 0;
+    std::uint64_t seed = 1;
+    std::uint64_t closedPercent = 30;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::uint64_t value = 0;
+        if (i + 1 >= argc || !parseNumber(argv[i + 1], value)) {
+            printUsage();
+            return 1;
+        }
+        ++i;
+
+        if (arg == "--max")
+            maxSize = value;
+        else if (arg == "--turns")
+            turns = std::max<std::uint64_t>(value, 1);
+        else if (arg == "--threads")
+            threads = value;
+        else if (arg == "--seed")
+            seed = value;
+        else if (arg == "--closed")
+            closedPercent = std::min<std::uint64_t>(value, 100);
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::cout << std::fixed
+              << "   поле      клеток  мкс/ход (медиана)  нс/клетку  перебор, мкс  ускорение\n";
+
+    bool mismatch = false;
+    for (double side = 10.0; static_cast<std::uint64_t>(side + 0.5) <= maxSize; side *= 3.1622776601683795) {
+        const std::size_t n = static_cast<std::size_t>(side + 0.5);
+        const std::size_t cells = n * n;
+
+        std::vector<int> weights(SHIP_COUNTS.begin(), SHIP_COUNTS.end());
+        for (int& w : weights)
+            w = static_cast<int>(std::max<std::size_t>(static_cast<std::size_t>(w) * cells / 100, static_cast<std::size_t>(w)));
+
+        std::mt19937 rng(static_cast<std::uint32_t>(seed + n));
+        std::bernoulli_distribution closed(static_cast<double>(closedPercent) / 100.0);
+        std::vector<std::uint8_t> blocked(cells);
+        for (auto& cell : blocked)
+            cell = closed(rng) ? 1 : 0;
+
+        LargeProbabilityMap map(n, n, static_cast<unsigned>(threads));
+
+        auto start = Clock::now();
+        const std::vector<int> brute = bruteCoverage(n, blocked, weights);
+        const double bruteSeconds = secondsSince(start);
+
+        std::vector<double> times;
+        for (std::uint64_t turn = 0; turn < turns; ++turn) {
+            start = Clock::now();
+            map.compute(blocked, weights);
+            const std::size_t target = map.best(blocked);
+            times.push_back(secondsSince(start));
+
+            if (turn == 0 && !std::equal(brute.begin(), brute.end(), map.map().begin()))
+                mismatch = true;
+            if (target == cells)
+                break;
+            blocked[target] = 1;
+        }
+
+        std::nth_element(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(times.size() / 2), times.end());
+        const double median = times[times.size() / 2];
+
+        std::cout << std::setw(7) << n
+                  << std::setw(12) << cells
+                  << std::setw(19) << std::setprecision(1) << median * 1e6
+                  << std::setw(11) << std::setprecision(2) << median * 1e9 / static_cast<double>(cells)
+                  << std::setw(14) << std::setprecision(1) << bruteSeconds * 1e6
+                  << std::setw(11) << std::setprecision(1) << bruteSeconds / median << '\n';
+    }
+
+    if (mismatch) {
+        std::cerr << "Карта расходится с прямым перебором\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+﻿#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "OpeningBook.h"
+#include "Profiler.h"
+#include "Simulation.h"
+
+// ------------------------------------------------------------
+//  Пакетный прогон ИИ без окна
+//
+//  battleship_sim [--games N] [--threads N] [--seed N] [--no-turn-timing]
+//                 [--search-nodes N] [--search-ms N] [--search-plies 1|2]
+//                 [--mc-samples N] [--endgame N] [--cache N] [--book FILE]
+//                 [--rules classic|five-ship|12x12|15x15] [--trace FILE]
+//                 [--uniform-fleets]
+//
+//  --uniform-fleets — флоты равномерно по всем расстановкам (FleetSampler)
+//  вместо Board::randomPlaceFleet; у незаконченных партий печатается ID флота.
+//  --trace включает замеры (Profiler): сводка — после отчёта,
+//  трасса Chrome — в FILE.
+// ------------------------------------------------------------
+namespace {
+
+    void printUsage() {
+        std::cerr << "Использование: battleship_sim [--games N] [--threads N] [--seed N] [--no-turn-timing]\n"
+                     "                      [--search-nodes N] [--search-ms N] [--search-plies 1|2]\n"
+                     "                      [--mc-samples N] [--endgame N] [--cache N] [--book FILE]\n"
+                     "                      [--rules NAME] [--trace FILE] [--uniform-fleets]\n"
+                     "Правила:";
+        for (std::string_view name : RULES_NAMES)
+            std::cerr << ' ' << name;
+        std::cerr << '\n';
+    }
+
+    bool parseNumber(const char* text, std::uint64_t& value) {
+        char* end = nullptr;
+        value = std::strtoull(text, &end, 10);
+        return end && *end == '\0' && end != text;
+    }
+
+    // Параметры поиска, включаемого любым из ключей --search-*
+    SearchConfig& searchConfig(SimulationConfig& config) {
+        if (!config.ai.search)
+            config.ai.search.emplace();
+        return *config.ai.search;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SimulationConfig config;
+    OpeningBook book;
+    bool nodesGiven = false;
+    std::string tracePath;
+    std::string bookPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::uint64_t value = 0;
+
+        if (arg == "--no-turn-timing") {
+            config.timeTurns = false;
+            continue;
+        }
+
+        if (arg == "--uniform-fleets") {
+            config.uniformFleets = true;
+            continue;
+        }
+
+        if (arg == "--rules" && i + 1 < argc) {
+            config.rules = argv[++i];
+            continue;
+        }
+
+        if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+            continue;
+        }
+
+        if (arg == "--book" && i + 1 < argc) {
+            bookPath = argv[++i];
+            continue;
+        }
+
+        if (i + 1 >= argc || !parseNumber(argv[i + 1], value)) {
+            printUsage();
+            return 1;
+        }
+        ++i;
+
+        if (arg == "--games")
+            config.games = value;
+        else if (arg == "--threads")
+            config.threads = static_cast<unsigned>(value);
+        else if (arg == "--seed")
+            config.seed = value;
+        else if (arg == "--search-nodes") {
+            searchConfig(config).nodes = value;
+            nodesGiven = true;
+        }
+        else if (arg == "--search-ms")
+            searchConfig(config).seconds = static_cast<double>(value) / 1000.0;
+        else if (arg == "--search-plies")
+            searchConfig(config).plies = static_cast<int>(value);
+        else if (arg == "--mc-samples")
+            config.ai.monteCarlo = MonteCarloConfig{ value, 1 };
+        else if (arg == "--cache")
+            config.cacheEntries = static_cast<std::size_t>(value);
+        else if (arg == "--endgame") {
+            config.ai.endgame.emplace();
+            config.ai.endgame->maxConfigurations = static_cast<std::size_t>(value);
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Только --search-ms — бюджет лишь по времени
+    if (config.ai.search && config.ai.search->seconds > 0.0 && !nodesGiven)
+        config.ai.search->nodes = 0;
+
+    // Книга проверяется по уже разобранным настройкам ИИ
+    if (!bookPath.empty()) {
+        if (!book.open(bookPath, config.ai)) {
+            std::cerr << "Не удалось открыть дебютную книгу " << bookPath << '\n';
+            return 1;
+        }
+        config.ai.book = &book;
+    }
+
+    if (!tracePath.empty())
+        Profiler::setEnabled(true);
+
+    const SimulationReport report = runSimulation(config);
+    if (report.games == 0 && config.games != 0)
+        return 1;
+    printReport(std::cout, report);
+
+    if (!tracePath.empty()) {
+        std::cout << '\n' << Profiler::summary();
+        if (!Profiler::writeChromeTrace(tracePath)) {
+            std::cerr << "Не удалось записать трассу в " << tracePath << '\n';
+            return 1;
+        }
+    }
+    if (report.unfinished)
+        return 2;
+    if (report.allocatingTurns && config.ai.allocationFree())
+        return 3;
+    return 0;
+}